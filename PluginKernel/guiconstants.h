@@ -311,6 +311,11 @@ enum class boundVariableType { kFloat, kDouble, kInt, kUInt };
 \brief
 The ParamSmoother object performs parameter smoothing on GUI control information. You can choose linear or exponential smoothing.
 
+smoothParameter( ) makes one value per call; advance( ) jumps n samples ahead in O(1) for block processing
+that only needs the value at the end of each block; smoothBlock( ) makes a whole ramp buffer, in closed form
+so the loops vectorize, for DSP that reads the ramp per sample; isConverged( ) tells the DSP in O(1) when it
+can go back to a constant value.
+
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
@@ -335,6 +340,10 @@ public:
 
 		// --- for linear smoother
 		linInc = (maxVal - minVal) / (smoothingTimeInMSec * 0.001 * sampleRate);
+
+		// --- for block smoothing: a^4 steps the four interleaved LPF decays
+		a4 = a*a*a*a;
+		convergedDelta = (maxVal - minVal) * 1.0e-7;
 	}
 
 	/** initialize the smoother; this recalculates internal coefficients
@@ -356,6 +365,7 @@ public:
 		maxVal = maxControlValue;
 		sampleRate = samplingRate;
 		smoothingTimeInMSec = smoothingTimeInMs;
+		smootherType = smoother;
 
 		setSampleRate(samplingRate);
 
@@ -373,12 +383,16 @@ public:
 	{
 		if (smootherType == smoothingMethod::kLPFSmoother)
 		{
-			z = (in * b) + (z * a);
-			if (z == z2)
+			if (z == in)
 			{
 				out = in;
 				return false;
 			}
+
+			// --- the decay stalls a hair short of the target; snap to it so isConverged( ) sees it
+			z = (in * b) + (z * a);
+			if (z == z2)
+				z = in;
 			z2 = z;
 			out = z2;
 			return true;
@@ -405,6 +419,117 @@ public:
 		}
 	}
 
+	/** true if the smoother has arrived at the target, so its output is constant; O(1)
+	\param target the value being smoothed to
+	\return true if smoothBlock( ) would only repeat the target
+	*/
+	inline bool isConverged(T target) const { return z == target; }
+
+	/** move the smoother numSamples samples ahead in O(1): the LPF decay in closed form,
+	target + (z - target)*a^n, snapped to the target once it is within 1e-7 of the control range; the
+	linear smoother moves n steps, clipped at the target
+	\param target the value being smoothed to
+	\param numSamples samples to advance
+	\return the smoothed value after the last of them
+	*/
+	inline T advance(T target, uint32_t numSamples)
+	{
+		if (numSamples == 0 || isConverged(target))
+			return z;
+
+		if (smootherType == smoothingMethod::kLPFSmoother)
+		{
+			z = target + (z - target)*pow(a, (T)numSamples);
+			if (fabs(z - target) <= convergedDelta)
+				z = target;
+		}
+		else // if (smootherType == smoothingMethod::kLinearSmoother)
+		{
+			T step = linInc <= 0.0 ? fabs(target - z) : linInc*(T)numSamples;
+			if (target > z)
+				z = z + step < target ? z + step : target;
+			else
+				z = z - step > target ? z - step : target;
+		}
+		z2 = z;
+		return z;
+	}
+
+	/** perform smoothing over a block; out[i] is the value for sample i. The LPF decay is stepped in closed
+	form, target + (z - target)*a^(i+1), four samples at a time, and snaps to the target once it is within
+	1e-7 of the control range; the linear smoother is a clipped ramp
+	\param target the value being smoothed to
+	\param out returned smoothed values, numSamples long
+	\param numSamples block length
+	\return true if smoothing occurred, false if the smoother had already converged (out is then all target)
+	*/
+	inline bool smoothBlock(T target, T* out, uint32_t numSamples)
+	{
+		if (numSamples == 0)
+			return !isConverged(target);
+
+		if (isConverged(target))
+		{
+			for (uint32_t i = 0; i < numSamples; i++)
+				out[i] = target;
+			z2 = target;
+			return false;
+		}
+
+		if (smootherType == smoothingMethod::kLPFSmoother)
+		{
+			T delta = z - target;
+			T decay[4] = { delta*a, delta*a*a, delta*a*a*a, delta*a4 };
+
+			uint32_t i = 0;
+			for (; i + 4 <= numSamples; i += 4)
+			{
+				for (uint32_t k = 0; k < 4; k++)
+				{
+					out[i + k] = target + decay[k];
+					decay[k] *= a4;
+				}
+			}
+			for (uint32_t k = 0; i < numSamples; i++, k++)
+				out[i] = target + decay[k];
+
+			z = out[numSamples - 1];
+			if (fabs(z - target) <= convergedDelta)
+				z = target;
+			z2 = z;
+			return true;
+		}
+		else // if (smootherType == smoothingMethod::kLinearSmoother)
+		{
+			// --- no ramp possible: jump
+			if (linInc <= 0.0)
+				z = target;
+
+			// --- one clipped ramp loop per direction, branch free inside
+			const T start = z;
+			if (target > start)
+			{
+				for (uint32_t i = 0; i < numSamples; i++)
+				{
+					T value = start + linInc*(T)(i + 1);
+					out[i] = value < target ? value : target;
+				}
+			}
+			else
+			{
+				for (uint32_t i = 0; i < numSamples; i++)
+				{
+					T value = start - linInc*(T)(i + 1);
+					out[i] = value > target ? value : target;
+				}
+			}
+
+			z = out[numSamples - 1];
+			z2 = z;
+			return true;
+		}
+	}
+
 private:
 	T a = 0.0;		///< a coefficient for smoothing
 	T b = 0.0;		///< b coefficient for smoothing
@@ -413,6 +538,9 @@ private:
 
 	T linInc = 0.0;	///< linear stepping value
 
+	T a4 = 0.0;				///< a^4, for smoothBlock( )
+	T convergedDelta = 0.0;	///< smoothBlock( ) snaps to the target this close
+
 	T minVal = 0.0;	///< min extrema
 	T maxVal = 1.0;	///< max exrema
 
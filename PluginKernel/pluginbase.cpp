@@ -55,9 +55,19 @@ PluginBase::~PluginBase()
     }
     pluginParameters.clear();
     pluginParameterMap.clear();
+    pluginParameterLookup.clear();
 	delete [] pluginParameterArray;
 	delete [] smoothablePluginParameters;
 	delete [] outboundPluginParameters;
+	delete [] automatedPluginParameters;
+	delete [] automationStartValues;
+	delete [] automationSampledCounts;
+	delete [] automationSampledOffsets;
+	delete [] automationSampledValues;
+	delete [] dirtyParameterFlags;
+
+	// --- after the parameters, which point into it
+	deleteParameterLiveStates(parameterLiveStates, parameterLiveStateMemory, numParameterLiveStates);
 }
 
 /**
@@ -98,21 +108,42 @@ bool PluginBase::initialize(PluginInfo& _pluginInfo)
 \brief initialize object for a new run of audio; called just before audio streams
 
 Operation:
-- iterate through parameters and copy their values into the bound variables you set up
+- visit the parameters whose value was written since the last sync (the dirty bitmask) and copy their values into the bound variables you set up
 - then, call the postUpdatePluginParameter method to do any post-update cooking required to use the variable for processing
+- when nothing was written this is a single atomic exchange of the summary word
 */
 void PluginBase::syncInBoundVariables()
 {
+	uint64_t dirtyWords = dirtyParameterSummary.exchange(0, std::memory_order_acquire);
+	if (dirtyWords == 0)
+		return;
+
 	ParameterUpdateInfo info;
 	info.bufferProcUpdate = true;
 	info.boundVariableUpdate = true;
 
-	// --- rip through and synch em
-	for (unsigned int i = 0; i < numPluginParameters; i++)
+	// --- rip through the flagged words and synch their flagged parameters
+	for (uint32_t word = 0; word < numDirtyParameterWords; word++)
 	{
-		if (pluginParameterArray[i] && pluginParameterArray[i]->updateInBoundVariable())
+		uint32_t summaryBit = word < 63 ? word : 63;
+		if (!(dirtyWords & ((uint64_t)1 << summaryBit)))
+			continue;
+
+		uint64_t dirty = dirtyParameterFlags[word].exchange(0, std::memory_order_acquire);
+		for (uint32_t bit = 0; dirty != 0; bit++, dirty >>= 1)
 		{
-			postUpdatePluginParameter(pluginParameterArray[i]->getControlID(), pluginParameterArray[i]->getControlValue(), info);
+			// --- skip clear bytes whole
+			while ((dirty & 0xFF) == 0)
+			{
+				dirty >>= 8;
+				bit += 8;
+			}
+			if (!(dirty & 1))
+				continue;
+
+			ParameterLiveState& liveState = parameterLiveStates[word * 64 + bit];
+			if (liveState.updateInBoundVariable())
+				postUpdatePluginParameter(liveState.controlID, liveState.getControlValue(), info);
 		}
 	}
 }
@@ -140,6 +171,9 @@ bool PluginBase::processAudioBuffers(ProcessBufferInfo& processBufferInfo)
 
 	double sampleInterval = 1.0 / audioProcDescriptor.sampleRate;
 
+	// --- let the frame processor know which channels are silent
+	detectInputSilence(processBufferInfo);
+
 	if (pluginDescriptor.processFrames)
 	{
 		ProcessFrameInfo info;
@@ -204,6 +238,61 @@ bool PluginBase::processAudioBuffers(ProcessBufferInfo& processBufferInfo)
 	return false; /// processed
 }
 
+/**
+\brief find the input channels that are all zeros for this buffer
+
+Operation:
+- the result goes to the plugin's own inputSilence word, rebuilt from scratch every buffer; the host's
+  inputSilenceFlags are only read, so a ProcessBufferInfo the wrapper reuses can't latch a channel silent
+- channels the host flagged for this buffer are trusted and not scanned
+- every other channel is scanned; the scan stops at the first non-zero sample, which for
+  live audio is almost always the first one
+- only the first 64 channels can be flagged; with more, the buffer is never reported as all silent
+
+\param processBufferInfo - the buffer to check
+
+\return true if every input channel is silent
+*/
+bool PluginBase::detectInputSilence(ProcessBufferInfo& processBufferInfo)
+{
+	inputSilence = 0;
+
+	uint32_t numChannels = processBufferInfo.numAudioInChannels;
+	if (numChannels == 0 || !processBufferInfo.inputs)
+		return false;
+
+	bool allSilent = numChannels <= 64;
+	for (uint32_t i = 0; i < numChannels && i < 64; i++)
+	{
+		uint64_t channelFlag = (uint64_t)1 << i;
+		if ((processBufferInfo.inputSilenceFlags & channelFlag) ||
+			(processBufferInfo.inputs[i] && isSilentBuffer(processBufferInfo.inputs[i], processBufferInfo.numFramesToProcess)))
+			inputSilence |= channelFlag;
+		else
+			allSilent = false;
+	}
+
+	return allSilent;
+}
+
+/**
+\brief check a channel buffer for silence
+
+\param buffer - the channel buffer
+\param numFrames - number of samples in the buffer
+
+\return true if every sample is zero
+*/
+bool PluginBase::isSilentBuffer(const float* buffer, uint32_t numFrames)
+{
+	for (uint32_t i = 0; i < numFrames; i++)
+	{
+		if (buffer[i] != 0.f)
+			return false;
+	}
+	return true;
+}
+
 /**
 \brief copy newly updated metering variables into GUI parameters for display
 
@@ -242,8 +331,12 @@ NOTE:
   as it was found to be faster than any other list method for entire-list iteration (if you have a faster way, let me knmow!)
 - the parameter is updated with the smoothed value
 - the post-parameter update function is then called (complex cooking functions here will eat the CPU as well)
+- block processing passes the length of the piece: each smoother jumps that far with one O(1) ParamSmoother::advance( )
+  and the parameter takes the value at the end of the piece; converged smoothers are skipped in O(1)
+
+\param numSamples - samples to advance the smoothers; 1 for frame processing
 */
-void PluginBase::doSampleAccurateParameterUpdates()
+void PluginBase::doSampleAccurateParameterUpdates(uint32_t numSamples)
 {
 	if (numSmoothablePluginParameters == 0)
 		return;
@@ -257,46 +350,297 @@ void PluginBase::doSampleAccurateParameterUpdates()
 	ParameterUpdateInfo paramSmoothUpdate(true, false); /// true = this is called from smoothing operation, false = NOT VST sample accurate update
 	paramSmoothUpdate.isSmoothing = true;
 
-	// --- rip through the array
+	// --- rip through the array; the smoothing only touches the live states, which are contiguous
 	for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
 	{
-		PluginParameter* piParam = smoothablePluginParameters[i];
-		if (piParam)
+		ParameterLiveState& liveState = parameterLiveStates[i];
+
+		// --- VST sample accurate stuff
+		if (wantsVST3SampleAccurateAutomation())
 		{
-			// --- VST sample accurate stuff
-			if (wantsVST3SampleAccurateAutomation())
+			PluginParameter* piParam = smoothablePluginParameters[i];
+
+			// --- if we get here getParameterUpdateQueue() should be non-null
+			//     NOTE you can disable sample accurate automation for each parameter when you set them up if needed
+			//     the queues are left to the sub-blocks when the derived class uses them
+			if (piParam->getParameterUpdateQueue() && piParam->getEnableVSTSampleAccurateAutomation() && !automationInSubBlocks)
 			{
-				// --- if we get here getParameterUpdateQueue() should be non-null
-				//     NOTE you can disable sample accurate automation for each parameter when you set them up if needed
-				if (piParam->getParameterUpdateQueue() && piParam->getEnableVSTSampleAccurateAutomation())
+				if (piParam->getParameterUpdateQueue()->getNextValue(value))
 				{
-					if (piParam->getParameterUpdateQueue()->getNextValue(value))
+					piParam->storeControlValueNormalized(value, false); // false = do not apply taper; no smoothing, and no dirty bit: we post it here
+					vstSAAutomated = true;
+
+					// --- now update the bound variable
+					if (piParam->updateInBoundVariable())
 					{
-						piParam->setControlValueNormalized(value, false, true); // false = do not apply taper, true = ignore smoothing (not needed here)
-						vstSAAutomated = true;
-
-						// --- now update the bound variable
-						if (piParam->updateInBoundVariable())
-						{
-							vst3Update.boundVariableUpdate = true;
-						}
-						postUpdatePluginParameter(piParam->getControlID(), piParam->getControlValue(), vst3Update);
+						vst3Update.boundVariableUpdate = true;
 					}
+					postUpdatePluginParameter(piParam->getControlID(), piParam->getControlValue(), vst3Update);
 				}
 			}
+		}
 
-			// --- do smoothing, but not if we did a sample accurate automation update!
-			if (!vstSAAutomated && piParam->smoothParameterValue())
+		// --- do smoothing, but not if we did a sample accurate automation update!
+		if (!vstSAAutomated && (numSamples == 1 ? liveState.smoothParameterValue() : liveState.smoothParameterBlock(numSamples)))
+		{
+			// --- update bound variable, if there is one
+			if (liveState.updateInBoundVariable())
 			{
-				// --- update bound variable, if there is one
-				if (piParam->updateInBoundVariable())
-				{
-					paramSmoothUpdate.boundVariableUpdate = true;
-				}
-				postUpdatePluginParameter(piParam->getControlID(), piParam->getControlValue(), paramSmoothUpdate);
+				paramSmoothUpdate.boundVariableUpdate = true;
+			}
+			postUpdatePluginParameter(liveState.controlID, liveState.getControlValue(), paramSmoothUpdate);
+		}
+	}
+}
+
+/**
+\brief check the smoothers; block processing uses this to decide whether the buffer must be cut into pieces
+       so the smoothed values can move between them
+
+\return true if any smoothable parameter's smoother is still moving
+*/
+bool PluginBase::isSmoothingParameters()
+{
+	for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
+	{
+		if (parameterLiveStates[i].isSmoothing())
+			return true;
+	}
+	return false;
+}
+
+/**
+\brief VST3 sample accurate automation for block processing: collect this buffer's automated parameters
+       and the frames where the buffer must be split so that each piece can be processed as one block
+
+Operation:
+- the split points are the automation points of every automated parameter, plus steps along the ramps
+  between them (the VST3 value is a linear ramp from point to point) every vst3SampleAccurateGranularity
+  samples, but no closer than MIN_AUTOMATION_RAMP_STEP
+- a parameter's ramp into its first point starts from its value at the top of the buffer
+- queues that can't list their points (getPointCount( ) < 0, the IParameterUpdateQueue default) are
+  sampled with getValueAtOffset( ) at the same steps and at the last frame; each change is a split
+- the caller applies applyAutomationAtFrame(0) before the first piece and applyAutomationAtFrame( ) at
+  each split, so automation costs a few calls per buffer instead of one per parameter per sample
+- from the first call on, doSampleAccurateParameterUpdates( ) no longer polls the queues per frame
+
+\param numFrames - the buffer length
+
+\return the number of split points in automationSplits
+*/
+uint32_t PluginBase::planAutomationSubBlocks(uint32_t numFrames)
+{
+	automationInSubBlocks = true;
+	numAutomatedPluginParameters = 0;
+	numAutomationSplits = 0;
+
+	if (!wantsVST3SampleAccurateAutomation() || !automatedPluginParameters)
+		return 0;
+
+	uint32_t rampStep = getAutomationRampStep();
+	for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
+	{
+		PluginParameter* piParam = smoothablePluginParameters[i];
+		if (!piParam || !piParam->getParameterUpdateQueue() || !piParam->getEnableVSTSampleAccurateAutomation())
+			continue;
+
+		int32_t numPoints = piParam->getParameterUpdateQueue()->getPointCount();
+		if (numPoints == 0)
+			continue;
+
+		uint32_t index = numAutomatedPluginParameters;
+		automatedPluginParameters[index] = piParam;
+		automationStartValues[index] = piParam->getNormalizedControlValueWithActualValue(piParam->getControlValue());
+		automationSampledCounts[index] = numPoints < 0 ? sampleAutomationQueue(index, numFrames, rampStep) : -1;
+
+		// --- a sampled queue that never moves needs nothing
+		if (automationSampledCounts[index] != 0)
+			numAutomatedPluginParameters++;
+	}
+
+	// --- the points go in first so they win if the list fills up
+	uint32_t sampleOffset = 0;
+	double value = 0.0;
+	for (unsigned int i = 0; i < numAutomatedPluginParameters; i++)
+	{
+		if (automationSampledCounts[i] >= 0)
+		{
+			for (int32_t point = 0; point < automationSampledCounts[i]; point++)
+				addAutomationSplit(automationSampledOffsets[i*MAX_SAMPLED_AUTOMATION_POINTS + point]);
+			continue;
+		}
+
+		IParameterUpdateQueue* queue = automatedPluginParameters[i]->getParameterUpdateQueue();
+		int32_t numPoints = queue->getPointCount();
+		for (int32_t point = 0; point < numPoints; point++)
+		{
+			if (queue->getPoint(point, sampleOffset, value) && sampleOffset < numFrames)
+				addAutomationSplit(sampleOffset);
+		}
+	}
+
+	// --- then the steps along the ramps; sampled queues were sampled at these steps already
+	for (unsigned int i = 0; i < numAutomatedPluginParameters; i++)
+	{
+		if (automationSampledCounts[i] >= 0)
+			continue;
+
+		IParameterUpdateQueue* queue = automatedPluginParameters[i]->getParameterUpdateQueue();
+		int32_t numPoints = queue->getPointCount();
+		uint32_t previousOffset = 0;
+		double previousValue = automationStartValues[i];
+		for (int32_t point = 0; point < numPoints; point++)
+		{
+			if (!queue->getPoint(point, sampleOffset, value))
+				break;
+
+			if (value != previousValue)
+			{
+				for (uint32_t frame = previousOffset + rampStep; frame < sampleOffset && frame < numFrames; frame += rampStep)
+					addAutomationSplit(frame);
 			}
+			previousOffset = sampleOffset;
+			previousValue = value;
 		}
 	}
+
+	return numAutomationSplits;
+}
+
+/**
+\brief VST3 sample accurate automation for block processing: set every automated parameter to its
+       ramp value at a frame and do the post-update cooking for those that moved
+
+\param frame - the first frame of the next piece of the buffer
+*/
+void PluginBase::applyAutomationAtFrame(uint32_t frame)
+{
+	ParameterUpdateInfo vst3Update(false, true); /// false = this is NOT called from smoothing operation, true: this is a VST sample accurate update
+	vst3Update.isVSTSampleAccurateUpdate = true;
+
+	for (unsigned int i = 0; i < numAutomatedPluginParameters; i++)
+	{
+		PluginParameter* piParam = automatedPluginParameters[i];
+		double value = getAutomationValueAtFrame(i, frame);
+		if (value == piParam->getNormalizedControlValueWithActualValue(piParam->getControlValue()))
+			continue;
+
+		piParam->storeControlValueNormalized(value, false); // false = do not apply taper; no smoothing, and no dirty bit: we post it here
+		vst3Update.boundVariableUpdate = piParam->updateInBoundVariable();
+		postUpdatePluginParameter(piParam->getControlID(), piParam->getControlValue(), vst3Update);
+	}
+}
+
+/**
+\brief sample a queue that can't list its points: getValueAtOffset( ) every step samples from frame 0,
+       and at the last frame so the buffer always ends on the queue's final value
+
+NOTE:
+- the offsets only ever increase, which is what the VST3 queue's getValueAtOffset( ) expects
+- only the changes are kept; when MAX_SAMPLED_AUTOMATION_POINTS fill up, later changes replace the last one
+
+\param index - index into automatedPluginParameters; automationStartValues[index] must be set
+\param numFrames - the buffer length
+\param step - samples between reads
+
+\return the number of values kept
+*/
+int32_t PluginBase::sampleAutomationQueue(uint32_t index, uint32_t numFrames, uint32_t step)
+{
+	IParameterUpdateQueue* queue = automatedPluginParameters[index]->getParameterUpdateQueue();
+	uint32_t* offsets = &automationSampledOffsets[index*MAX_SAMPLED_AUTOMATION_POINTS];
+	double* values = &automationSampledValues[index*MAX_SAMPLED_AUTOMATION_POINTS];
+
+	int32_t count = 0;
+	double previousValue = automationStartValues[index];
+	for (uint32_t frame = 0; frame < numFrames; )
+	{
+		double value = previousValue;
+		if (queue->getValueAtOffset((long int)frame, previousValue, value) && value != previousValue)
+		{
+			if (count == (int32_t)MAX_SAMPLED_AUTOMATION_POINTS)
+				count--;
+			offsets[count] = frame;
+			values[count] = value;
+			count++;
+			previousValue = value;
+		}
+
+		if (frame == numFrames - 1)
+			break;
+		frame = frame + step < numFrames - 1 ? frame + step : numFrames - 1;
+	}
+	return count;
+}
+
+/**
+\brief the normalized value of an automated parameter at a frame: linear between its points, from its
+       value at the top of the buffer into the first point, and held after the last; a sampled queue
+       holds each sampled value until the next
+
+\param index - index into automatedPluginParameters
+\param frame - the frame
+
+\return normalized value
+*/
+double PluginBase::getAutomationValueAtFrame(uint32_t index, uint32_t frame)
+{
+	if (automationSampledCounts[index] >= 0)
+	{
+		const uint32_t* offsets = &automationSampledOffsets[index*MAX_SAMPLED_AUTOMATION_POINTS];
+		const double* values = &automationSampledValues[index*MAX_SAMPLED_AUTOMATION_POINTS];
+		double heldValue = automationStartValues[index];
+		for (int32_t point = 0; point < automationSampledCounts[index] && offsets[point] <= frame; point++)
+			heldValue = values[point];
+		return heldValue;
+	}
+
+	IParameterUpdateQueue* queue = automatedPluginParameters[index]->getParameterUpdateQueue();
+	int32_t numPoints = queue->getPointCount();
+
+	uint32_t previousOffset = 0;
+	double previousValue = automationStartValues[index];
+	uint32_t sampleOffset = 0;
+	double value = 0.0;
+	for (int32_t point = 0; point < numPoints; point++)
+	{
+		if (!queue->getPoint(point, sampleOffset, value))
+			break;
+
+		if (sampleOffset >= frame)
+		{
+			if (sampleOffset == previousOffset)
+				return value;
+			return previousValue + (value - previousValue)*(double)(frame - previousOffset) / (double)(sampleOffset - previousOffset);
+		}
+		previousOffset = sampleOffset;
+		previousValue = value;
+	}
+	return previousValue;
+}
+
+/**
+\brief add a split point to automationSplits, keeping it sorted and free of repeats; frame 0 and
+       points past MAX_AUTOMATION_SPLITS are dropped
+
+\param frame - the split point
+*/
+void PluginBase::addAutomationSplit(uint32_t frame)
+{
+	if (frame == 0)
+		return;
+
+	uint32_t i = numAutomationSplits;
+	for (; i > 0 && automationSplits[i - 1] > frame; i--) {}
+	if (i > 0 && automationSplits[i - 1] == frame)
+		return;
+	if (numAutomationSplits >= MAX_AUTOMATION_SPLITS)
+		return;
+
+	for (uint32_t j = numAutomationSplits; j > i; j--)
+		automationSplits[j] = automationSplits[j - 1];
+	automationSplits[i] = frame;
+	numAutomationSplits++;
 }
 
 /**
@@ -315,6 +659,15 @@ int32_t PluginBase::addPluginParameter(PluginParameter* piParam, double sampleRa
 	// --- map for controlID-indexing
 	pluginParameterMap.insert(std::make_pair(piParam->getControlID(), piParam));
 
+	// --- dense table for O(1) controlID-indexing; control IDs are small, so it has few holes
+	uint32_t controlID = piParam->getControlID();
+	if (controlID < MAX_DENSE_CONTROL_ID)
+	{
+		if (controlID >= pluginParameterLookup.size())
+			pluginParameterLookup.resize(controlID + 1, nullptr);
+		pluginParameterLookup[controlID] = piParam;
+	}
+
 	// --- vector for fast iteration and 0-indexing
 	pluginParameters.push_back(piParam);
 
@@ -812,8 +1165,6 @@ void PluginBase::initPluginParameterArray()
 	pluginParameterArray = new PluginParameter*[numPluginParameters];
 	for (unsigned int i = 0; i < numPluginParameters; i++)
 	{
-		pluginParameterArray[i] = pluginParameters[i];
-
 		// --- how many are potentially smoothable?
 		if (pluginParameters[i]->getControlVariableType() == controlVariableType::kDouble ||
 			pluginParameters[i]->getControlVariableType() == controlVariableType::kFloat)
@@ -824,6 +1175,40 @@ void PluginBase::initPluginParameterArray()
 			numOutboundPluginParameters++;
 	}
 
+	// --- smoothable parameters first, so the smoothing loop walks the front of the live state array
+	uint32_t nextSmoothable = 0;
+	uint32_t nextOther = numSmoothablePluginParameters;
+	for (unsigned int i = 0; i < numPluginParameters; i++)
+	{
+		if (pluginParameters[i]->getControlVariableType() == controlVariableType::kDouble ||
+			pluginParameters[i]->getControlVariableType() == controlVariableType::kFloat)
+			pluginParameterArray[nextSmoothable++] = pluginParameters[i];
+		else
+			pluginParameterArray[nextOther++] = pluginParameters[i];
+	}
+
+	// --- live states: a new aligned block; each parameter copies its state into its slot, then the old block goes
+	ParameterLiveState* oldLiveStates = parameterLiveStates;
+	char* oldLiveStateMemory = parameterLiveStateMemory;
+	uint32_t numOldLiveStates = numParameterLiveStates;
+
+	parameterLiveStates = nullptr;
+	parameterLiveStateMemory = nullptr;
+	numParameterLiveStates = 0;
+	if (numPluginParameters > 0)
+	{
+		parameterLiveStateMemory = new char[numPluginParameters*sizeof(ParameterLiveState) + PARAMETER_LIVE_STATE_ALIGNMENT - 1];
+		uintptr_t address = ((uintptr_t)parameterLiveStateMemory + PARAMETER_LIVE_STATE_ALIGNMENT - 1) & ~((uintptr_t)PARAMETER_LIVE_STATE_ALIGNMENT - 1);
+		parameterLiveStates = (ParameterLiveState*)address;
+		for (uint32_t i = 0; i < numPluginParameters; i++)
+		{
+			new (&parameterLiveStates[i]) ParameterLiveState;
+			pluginParameterArray[i]->setLiveState(&parameterLiveStates[i]);
+		}
+		numParameterLiveStates = numPluginParameters;
+	}
+	deleteParameterLiveStates(oldLiveStates, oldLiveStateMemory, numOldLiveStates);
+
 	// --- smoothable parameters; this is called during audio processing so we want this array to be as small as possible
 	if (smoothablePluginParameters)
 		delete[] smoothablePluginParameters;
@@ -832,12 +1217,56 @@ void PluginBase::initPluginParameterArray()
 	if (numSmoothablePluginParameters > 0)
 	{
 		smoothablePluginParameters = new PluginParameter*[numSmoothablePluginParameters];
-		for (unsigned int i = 0; i < numPluginParameters; i++)
-		{
-			if (pluginParameters[i]->getControlVariableType() == controlVariableType::kDouble ||
-				pluginParameters[i]->getControlVariableType() == controlVariableType::kFloat)
-				smoothablePluginParameters[m++] = pluginParameters[i];
-		}
+		for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
+			smoothablePluginParameters[m++] = pluginParameterArray[i];
+	}
+
+	// --- dirty bitmask; every inbound parameter starts flagged so the first sync copies them all
+	if (dirtyParameterFlags)
+		delete[] dirtyParameterFlags;
+
+	numDirtyParameterWords = (numPluginParameters + 63) / 64;
+	dirtyParameterFlags = numDirtyParameterWords > 0 ? new std::atomic<uint64_t>[numDirtyParameterWords] : nullptr;
+	for (uint32_t word = 0; word < numDirtyParameterWords; word++)
+		dirtyParameterFlags[word] = 0;
+
+	for (uint32_t i = 0; i < numPluginParameters; i++)
+	{
+		if (pluginParameterArray[i]->getControlVariableType() == controlVariableType::kMeter)
+			continue;
+
+		uint32_t word = i / 64;
+		uint32_t summaryBit = word < 63 ? word : 63;
+		pluginParameterArray[i]->setDirtyFlags(&dirtyParameterFlags[word], &dirtyParameterSummary, i % 64, summaryBit);
+		dirtyParameterFlags[word] |= (uint64_t)1 << (i % 64);
+		dirtyParameterSummary |= (uint64_t)1 << summaryBit;
+	}
+
+	// --- sample accurate automation in sub-blocks draws from the smoothable parameters
+	if (automatedPluginParameters)
+		delete[] automatedPluginParameters;
+	if (automationStartValues)
+		delete[] automationStartValues;
+	if (automationSampledCounts)
+		delete[] automationSampledCounts;
+	if (automationSampledOffsets)
+		delete[] automationSampledOffsets;
+	if (automationSampledValues)
+		delete[] automationSampledValues;
+
+	automatedPluginParameters = nullptr;
+	automationStartValues = nullptr;
+	automationSampledCounts = nullptr;
+	automationSampledOffsets = nullptr;
+	automationSampledValues = nullptr;
+	numAutomatedPluginParameters = 0;
+	if (numSmoothablePluginParameters > 0)
+	{
+		automatedPluginParameters = new PluginParameter*[numSmoothablePluginParameters];
+		automationStartValues = new double[numSmoothablePluginParameters];
+		automationSampledCounts = new int32_t[numSmoothablePluginParameters];
+		automationSampledOffsets = new uint32_t[numSmoothablePluginParameters*MAX_SAMPLED_AUTOMATION_POINTS];
+		automationSampledValues = new double[numSmoothablePluginParameters*MAX_SAMPLED_AUTOMATION_POINTS];
 	}
 
 	if (outboundPluginParameters)
@@ -856,6 +1285,20 @@ void PluginBase::initPluginParameterArray()
 
 }
 
+/**
+\brief destroy a block of live states made by initPluginParameterArray( ); no parameter may still point into it
+
+\param liveStates the aligned array
+\param memory the allocation it sits in
+\param count number of live states
+*/
+void PluginBase::deleteParameterLiveStates(ParameterLiveState* liveStates, char* memory, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++)
+		liveStates[i].~ParameterLiveState();
+	delete[] memory;
+}
+
 /**
 \brief helper function to compare a PluginParameter's value with a string version of it
 
@@ -195,6 +195,23 @@ The AAX plugin shell consists of the following files:
 #include "pluginparameter.h"
 
 #include <map>
+#include <new>
+
+// --- most split points sample accurate automation makes in one buffer (see planAutomationSubBlocks( ));
+//     automation points take priority over ramp steps when there are more
+const uint32_t MAX_AUTOMATION_SPLITS = 64;
+
+// --- automation ramps are followed in steps of vst3SampleAccurateGranularity samples, but no finer than this
+const uint32_t MIN_AUTOMATION_RAMP_STEP = 16;
+
+// --- most values kept per automated parameter when its queue can't list its points and is sampled instead
+const uint32_t MAX_SAMPLED_AUTOMATION_POINTS = MAX_AUTOMATION_SPLITS + 1;
+
+// --- control IDs below this are found by direct index (see getPluginParameterByControlID( )); larger ones fall back to the map
+const uint32_t MAX_DENSE_CONTROL_ID = 4096;
+
+// --- the parameter live state array starts on a cache line (see initPluginParameterArray( ))
+const uint32_t PARAMETER_LIVE_STATE_ALIGNMENT = 64;
 
 /**
 \class PluginBase
@@ -256,6 +273,15 @@ public:
 	/** Buffer Proc Cycle: II PluginCore overrides this method to process frames */
 	virtual bool processAudioBuffers(ProcessBufferInfo& processInfo);
 
+	/** flag this buffer's all-zero input channels in inputSilence; returns true if every input channel is silent */
+	bool detectInputSilence(ProcessBufferInfo& processInfo);
+
+	/** this buffer's silent input channels, bit n = channel n; valid after detectInputSilence( ) */
+	uint64_t getInputSilenceFlags() { return inputSilence; }
+
+	/** true if the buffer holds only zeros */
+	static bool isSilentBuffer(const float* buffer, uint32_t numFrames);
+
 	/** Buffer Proc Cycle: III connects meter variables to outbound GUI control changes (part of ASPiK output variable binding option) */
 	bool updateOutBoundVariables();
 
@@ -268,8 +294,20 @@ public:
 	/** ASPiK midi event system: base class implementation is empty */
 	virtual bool processMIDIEvent(midiEvent& event) { return true; }
 
-	/** perform parameter smoothing or VST3 sample accurate upates */
-	void doSampleAccurateParameterUpdates();
+	/** perform parameter smoothing or VST3 sample accurate upates; numSamples > 1 advances the smoothers a whole block */
+	void doSampleAccurateParameterUpdates(uint32_t numSamples = 1);
+
+	/** true if any parameter's smoother has not yet reached its target */
+	bool isSmoothingParameters();
+
+	/** VST3 sample accurate automation for block processing: find where this buffer must be split */
+	uint32_t planAutomationSubBlocks(uint32_t numFrames);
+
+	/** block processing: the piece length for following automation ramps and smoothers; vst3SampleAccurateGranularity, floored at MIN_AUTOMATION_RAMP_STEP */
+	uint32_t getAutomationRampStep() { return getVST3SampleAccuracyGranularity() > MIN_AUTOMATION_RAMP_STEP ? getVST3SampleAccuracyGranularity() : MIN_AUTOMATION_RAMP_STEP; }
+
+	/** VST3 sample accurate automation for block processing: move the automated parameters to their values at a split */
+	void applyAutomationAtFrame(uint32_t frame);
 
 	/** only for a vector joystick control from DAW that implements it (reserved for future use): base class implementation is empty */
 	virtual bool setVectorJoystickParameters(const VectorJoystickData& vectorJoysickData) { return true; }
@@ -293,13 +331,21 @@ public:
 	PluginParameter* getPluginParameterByIndex(int32_t index) { return pluginParameters[index]; }
 
 	/**
-	\brief get a parameter by control ID - uses map (slowest)
+	\brief get a parameter by control ID - direct index into pluginParameterLookup; the map is only searched for
+	       control IDs of MAX_DENSE_CONTROL_ID and up
 
 	\param controlID the control ID of the parameter
 
-	\return a naked pointer to the PluginParameter object
+	\return a naked pointer to the PluginParameter object, or nullptr if there is none with that ID
 	*/
-	PluginParameter* getPluginParameterByControlID(int32_t controlID) { return pluginParameterMap[controlID]; }
+	PluginParameter* getPluginParameterByControlID(int32_t controlID)
+	{
+		if (controlID >= 0 && (uint32_t)controlID < MAX_DENSE_CONTROL_ID)
+			return (uint32_t)controlID < pluginParameterLookup.size() ? pluginParameterLookup[controlID] : nullptr;
+
+		pluginParameterControlIDMap::iterator it = pluginParameterMap.find(controlID);
+		return it != pluginParameterMap.end() ? it->second : nullptr;
+	}
 
 	/** get a parameter by type - used to find all meter variables for writing to GUI */
 	PluginParameter* getNextParameterOfType(int32_t& startIndex, controlVariableType controlType);
@@ -604,6 +650,46 @@ protected:
 	PluginParameter** outboundPluginParameters = nullptr;		///< old-fashioned C-arrays of pointers for outbound (meter) parameters
 	uint32_t numOutboundPluginParameters = 0;					///< total number of outbound (meter) parameters
 
+	// --- dirty bitmask: one bit per pluginParameterArray entry, set by every write to the control value (see
+	//     PluginParameter::setDirtyFlags( )); bit w of the summary flags word w, words 63 and up share bit 63
+	std::atomic<uint64_t>* dirtyParameterFlags = nullptr;		///< bitmask words, 64 parameters each
+	uint32_t numDirtyParameterWords = 0;						///< words in dirtyParameterFlags
+	std::atomic<uint64_t> dirtyParameterSummary{ 0 };			///< words that may have bits set
+
+	// --- sample accurate automation in sub-blocks, see planAutomationSubBlocks( )
+	PluginParameter** automatedPluginParameters = nullptr;		///< this buffer's parameters with automation points
+	double* automationStartValues = nullptr;					///< normalized value of each at the start of the buffer
+	uint32_t numAutomatedPluginParameters = 0;					///< entries in automatedPluginParameters
+	uint32_t automationSplits[MAX_AUTOMATION_SPLITS] = {};		///< this buffer's split points, ascending, no repeats, never 0
+	uint32_t numAutomationSplits = 0;							///< entries in automationSplits
+	bool automationInSubBlocks = false;							///< true = the queues are run by the sub-blocks, not polled per frame
+
+	uint64_t inputSilence = 0;									///< this buffer's silent input channels, rebuilt by detectInputSilence( )
+
+	// --- queues that can't list their points are sampled with getValueAtOffset( ); MAX_SAMPLED_AUTOMATION_POINTS per parameter
+	int32_t* automationSampledCounts = nullptr;					///< per automated parameter: values sampled, or -1 if the queue lists its points
+	uint32_t* automationSampledOffsets = nullptr;				///< sample offset of each value where it changed
+	double* automationSampledValues = nullptr;					///< normalized value from that offset on
+
+	/** normalized value of an automated parameter at a frame of this buffer */
+	double getAutomationValueAtFrame(uint32_t index, uint32_t frame);
+
+	/** sample a queue that can't list its points */
+	int32_t sampleAutomationQueue(uint32_t index, uint32_t numFrames, uint32_t step);
+
+	/** add a split point to automationSplits */
+	void addAutomationSplit(uint32_t frame);
+
+	// --- hot/cold split: the live state (value, smoother, bound variable) of every pluginParameterArray entry, in the same
+	//     order, in one cache-line aligned block; see ParameterLiveState. The smoothable parameters are at the front of
+	//     pluginParameterArray, so entry i of smoothablePluginParameters has its live state at parameterLiveStates[i]
+	ParameterLiveState* parameterLiveStates = nullptr;			///< live states, one per pluginParameterArray entry
+	char* parameterLiveStateMemory = nullptr;					///< the allocation parameterLiveStates is aligned within
+	uint32_t numParameterLiveStates = 0;						///< entries in parameterLiveStates
+
+	/** destroy a block of live states made by initPluginParameterArray( ) */
+	static void deleteParameterLiveStates(ParameterLiveState* liveStates, char* memory, uint32_t count);
+
     // --- vectorized version of pluginParameterMap for fast iteration when key not needed
     std::vector<PluginParameter*> pluginParameters;				///< vector version of parameter list
 
@@ -611,6 +697,9 @@ protected:
     typedef std::map<uint32_t, PluginParameter*> pluginParameterControlIDMap;	///< map version of parameter list
     pluginParameterControlIDMap pluginParameterMap;								///< member map of parameter list
 
+    // --- controlID-indexed version of pluginParameterMap; nullptr for unused IDs
+    std::vector<PluginParameter*> pluginParameterLookup;						///< dense parameter list, IDs below MAX_DENSE_CONTROL_ID
+
     // --- plugin core -> host (wrap) connector
     IPluginHostConnector* pluginHostConnector = nullptr;						///< created and destroyed on host
 
@@ -34,6 +34,16 @@ PluginCore::PluginCore()
 		addSupportedIOCombination({ kCFMono, kCFMono });
 		addSupportedIOCombination({ kCFMono, kCFStereo });
 		addSupportedIOCombination({ kCFStereo, kCFStereo });
+
+		// --- surround: mono, stereo or the same layout in, rotated round the speakers (see AutoPan)
+		const channelFormat surroundFormats[] = { kCFLCR, kCFLCRS, kCFQuad, kCF5p0, kCF5p1, kCF6p0, kCF6p1,
+												  kCF7p0Sony, kCF7p0DTS, kCF7p1Sony, kCF7p1DTS, kCF7p1Proximity };
+		for (channelFormat format : surroundFormats)
+		{
+			addSupportedIOCombination({ kCFMono, format });
+			addSupportedIOCombination({ kCFStereo, format });
+			addSupportedIOCombination({ format, format });
+		}
 	}
 	else // --- synth plugins have no input, only output
 	{
@@ -50,6 +60,9 @@ PluginCore::PluginCore()
 
     // --- create the presets
     initPluginPresets();
+
+	// --- control ID -> AutoPan change group, for postUpdatePluginParameter( )
+	initAutoPanChangeFlags();
 }
 
 /**
@@ -306,6 +319,148 @@ bool PluginCore::initPluginParameters()
 	piParam->setBoundVariable(&LFOdPhase, boundVariableType::kInt);
 	addPluginParameter(piParam);
 
+	// --- discrete control: Pan Law
+	piParam = new PluginParameter(controlID::panLawSelector, "Pan Law", "-3 dB,-4.5 dB,-6 dB,Linear", "-3 dB");
+	piParam->setBoundVariable(&panLawSelector, boundVariableType::kInt);
+	piParam->setIsDiscreteSwitch(true);
+	addPluginParameter(piParam);
+
+	// --- discrete control: LFO Control Rate (samples per LFO update)
+	piParam = new PluginParameter(controlID::LFOControlRateSelector, "LFO Control Rate", "Full,8,16,32,64", "16");
+	piParam->setBoundVariable(&LFOControlRateSelector, boundVariableType::kInt);
+	piParam->setIsDiscreteSwitch(true);
+	addPluginParameter(piParam);
+
+	// --- discrete control: LFO Interpolation
+	piParam = new PluginParameter(controlID::LFOInterpolationSelector, "LFO Interpolation", "Linear,Cubic", "Linear");
+	piParam->setBoundVariable(&LFOInterpolationSelector, boundVariableType::kInt);
+	piParam->setIsDiscreteSwitch(true);
+	addPluginParameter(piParam);
+
+	// --- discrete control: LFO Transport Lock (LFO phases follow the host position)
+	piParam = new PluginParameter(controlID::LFOTransportLock, "LFO Transport Lock", "SWITCH OFF,SWITCH ON", "SWITCH OFF");
+	piParam->setBoundVariable(&LFOTransportLock, boundVariableType::kInt);
+	piParam->setIsDiscreteSwitch(true);
+	addPluginParameter(piParam);
+
+	// --- discrete control: LFO A Breakpoint (play the breakpoint shape instead of the waveform)
+	piParam = new PluginParameter(controlID::LFOaBreakpoint, "LFO A Breakpoint", "SWITCH OFF,SWITCH ON", "SWITCH OFF");
+	piParam->setBoundVariable(&LFOaBreakpoint, boundVariableType::kInt);
+	piParam->setIsDiscreteSwitch(true);
+	addPluginParameter(piParam);
+
+	// --- discrete control: LFO B Breakpoint
+	piParam = new PluginParameter(controlID::LFObBreakpoint, "LFO B Breakpoint", "SWITCH OFF,SWITCH ON", "SWITCH OFF");
+	piParam->setBoundVariable(&LFObBreakpoint, boundVariableType::kInt);
+	piParam->setIsDiscreteSwitch(true);
+	addPluginParameter(piParam);
+
+	// --- discrete control: LFO C Breakpoint
+	piParam = new PluginParameter(controlID::LFOcBreakpoint, "LFO C Breakpoint", "SWITCH OFF,SWITCH ON", "SWITCH OFF");
+	piParam->setBoundVariable(&LFOcBreakpoint, boundVariableType::kInt);
+	piParam->setIsDiscreteSwitch(true);
+	addPluginParameter(piParam);
+
+	// --- discrete control: LFO D Breakpoint
+	piParam = new PluginParameter(controlID::LFOdBreakpoint, "LFO D Breakpoint", "SWITCH OFF,SWITCH ON", "SWITCH OFF");
+	piParam->setBoundVariable(&LFOdBreakpoint, boundVariableType::kInt);
+	piParam->setIsDiscreteSwitch(true);
+	addPluginParameter(piParam);
+
+	// --- discrete control: LFO A Trigger (what a MIDI note-on does to the LFO; listed in LFOMode order)
+	piParam = new PluginParameter(controlID::LFOaTrigger, "LFO A Trigger", "Retrigger,One Shot,Free Run", "Free Run");
+	piParam->setBoundVariable(&LFOaTrigger, boundVariableType::kInt);
+	piParam->setIsDiscreteSwitch(true);
+	addPluginParameter(piParam);
+
+	// --- discrete control: LFO B Trigger
+	piParam = new PluginParameter(controlID::LFObTrigger, "LFO B Trigger", "Retrigger,One Shot,Free Run", "Free Run");
+	piParam->setBoundVariable(&LFObTrigger, boundVariableType::kInt);
+	piParam->setIsDiscreteSwitch(true);
+	addPluginParameter(piParam);
+
+	// --- discrete control: LFO C Trigger
+	piParam = new PluginParameter(controlID::LFOcTrigger, "LFO C Trigger", "Retrigger,One Shot,Free Run", "Free Run");
+	piParam->setBoundVariable(&LFOcTrigger, boundVariableType::kInt);
+	piParam->setIsDiscreteSwitch(true);
+	addPluginParameter(piParam);
+
+	// --- discrete control: LFO D Trigger
+	piParam = new PluginParameter(controlID::LFOdTrigger, "LFO D Trigger", "Retrigger,One Shot,Free Run", "Free Run");
+	piParam->setBoundVariable(&LFOdTrigger, boundVariableType::kInt);
+	piParam->setIsDiscreteSwitch(true);
+	addPluginParameter(piParam);
+
+	// --- continuous control: Breakpoint Count
+	piParam = new PluginParameter(controlID::breakpointCount, "Breakpoint Count", "", controlVariableType::kInt, 1.000000, (double)LFO_MAX_BREAKPOINTS, 4.000000, taper::kLinearTaper);
+	piParam->setParameterSmoothing(false);
+	piParam->setBoundVariable(&breakpointCount, boundVariableType::kInt);
+	addPluginParameter(piParam);
+
+	// --- continuous controls: Breakpoint n Phase, Level and Curve; the default shape is a
+	//     triangle through (0, 0), (0.25, 1), (0.5, 0), (0.75, -1); spare points wait at the end
+	const double breakpointDefaultPhase[LFO_MAX_BREAKPOINTS] = { 0.0, 0.25, 0.5, 0.75, 1.0, 1.0, 1.0, 1.0 };
+	const double breakpointDefaultLevel[LFO_MAX_BREAKPOINTS] = { 0.0, 1.0, 0.0, -1.0, 0.0, 0.0, 0.0, 0.0 };
+	for (uint32_t i = 0; i < LFO_MAX_BREAKPOINTS; i++)
+	{
+		std::string pointName = "Breakpoint " + std::to_string(i + 1);
+
+		piParam = new PluginParameter(controlID::breakpoint1Phase + i, (pointName + " Phase").c_str(), "", controlVariableType::kDouble, 0.000000, 1.000000, breakpointDefaultPhase[i], taper::kLinearTaper);
+		piParam->setParameterSmoothing(false);
+		piParam->setBoundVariable(&breakpointPhase[i], boundVariableType::kDouble);
+		addPluginParameter(piParam);
+
+		piParam = new PluginParameter(controlID::breakpoint1Level + i, (pointName + " Level").c_str(), "", controlVariableType::kDouble, -1.000000, 1.000000, breakpointDefaultLevel[i], taper::kLinearTaper);
+		piParam->setParameterSmoothing(false);
+		piParam->setBoundVariable(&breakpointLevel[i], boundVariableType::kDouble);
+		addPluginParameter(piParam);
+
+		piParam = new PluginParameter(controlID::breakpoint1Curve + i, (pointName + " Curve").c_str(), "", controlVariableType::kDouble, -1.000000, 1.000000, 0.000000, taper::kLinearTaper);
+		piParam->setParameterSmoothing(false);
+		piParam->setBoundVariable(&breakpointCurve[i], boundVariableType::kDouble);
+		addPluginParameter(piParam);
+	}
+
+	// --- Modulation matrix routes: discrete Source and Destination, continuous Amount; route 1 is
+	//     LFO Mix -> Pan at full amount, the classic AutoPan, the others start unused
+	for (uint32_t i = 0; i < AUTOPAN_NUM_MOD_ROUTES; i++)
+	{
+		std::string routeName = "Mod " + std::to_string(i + 1);
+
+		piParam = new PluginParameter(controlID::modSource1 + i, (routeName + " Source").c_str(), "LFO Mix,LFO A,LFO B,LFO C,LFO D,Sidechain", "LFO Mix");
+		piParam->setBoundVariable(&modSource[i], boundVariableType::kInt);
+		piParam->setIsDiscreteSwitch(true);
+		addPluginParameter(piParam);
+
+		piParam = new PluginParameter(controlID::modDestination1 + i, (routeName + " Destination").c_str(), "Pan,Width,Volume,LFO A Rate,LFO B Rate,LFO C Rate,LFO D Rate,LFO A Depth,LFO B Depth,LFO C Depth,LFO D Depth", "Pan");
+		piParam->setBoundVariable(&modDestination[i], boundVariableType::kInt);
+		piParam->setIsDiscreteSwitch(true);
+		addPluginParameter(piParam);
+
+		piParam = new PluginParameter(controlID::modAmount1 + i, (routeName + " Amount").c_str(), "", controlVariableType::kDouble, -1.000000, 1.000000, i == 0 ? 1.000000 : 0.000000, taper::kLinearTaper);
+		piParam->setParameterSmoothing(false);
+		piParam->setBoundVariable(&modAmount[i], boundVariableType::kDouble);
+		addPluginParameter(piParam);
+	}
+
+	// --- continuous control: Sidechain Attack
+	piParam = new PluginParameter(controlID::sidechainAttack_mSec, "Sidechain Attack", "mSec", controlVariableType::kDouble, 0.100000, 500.000000, 10.000000, taper::kVoltOctaveTaper);
+	piParam->setParameterSmoothing(false);
+	piParam->setBoundVariable(&sidechainAttack_mSec, boundVariableType::kDouble);
+	addPluginParameter(piParam);
+
+	// --- continuous control: Sidechain Release
+	piParam = new PluginParameter(controlID::sidechainRelease_mSec, "Sidechain Release", "mSec", controlVariableType::kDouble, 1.000000, 2000.000000, 200.000000, taper::kVoltOctaveTaper);
+	piParam->setParameterSmoothing(false);
+	piParam->setBoundVariable(&sidechainRelease_mSec, boundVariableType::kDouble);
+	addPluginParameter(piParam);
+
+	// --- discrete control: Sidechain Detect (TLD_AUDIO_DETECT_MODE_* order)
+	piParam = new PluginParameter(controlID::sidechainDetectMode, "Sidechain Detect", "Peak,MS,RMS", "Peak");
+	piParam->setBoundVariable(&sidechainDetectMode, boundVariableType::kInt);
+	piParam->setIsDiscreteSwitch(true);
+	addPluginParameter(piParam);
+
 	// --- BONUS Parameters
 	// --- SCALE_GUI_SIZE
 	piParam = new PluginParameter(SCALE_GUI_SIZE, "Scale GUI", "tiny,small,medium,normal,large,giant", "normal");
@@ -496,6 +651,77 @@ bool PluginCore::initPluginParameters()
 	auxAttribute.setUintAttribute(2147483648);
 	setParamAuxAttribute(controlID::LFOdPhase, auxAttribute);
 
+	// --- controlID::panLawSelector
+	auxAttribute.reset(auxGUIIdentifier::guiControlData);
+	auxAttribute.setUintAttribute(268435456);
+	setParamAuxAttribute(controlID::panLawSelector, auxAttribute);
+
+	// --- controlID::LFOControlRateSelector
+	auxAttribute.reset(auxGUIIdentifier::guiControlData);
+	auxAttribute.setUintAttribute(268435456);
+	setParamAuxAttribute(controlID::LFOControlRateSelector, auxAttribute);
+
+	// --- controlID::LFOInterpolationSelector
+	auxAttribute.reset(auxGUIIdentifier::guiControlData);
+	auxAttribute.setUintAttribute(268435456);
+	setParamAuxAttribute(controlID::LFOInterpolationSelector, auxAttribute);
+
+	// --- controlID::LFOTransportLock
+	auxAttribute.reset(auxGUIIdentifier::guiControlData);
+	auxAttribute.setUintAttribute(1073741824);
+	setParamAuxAttribute(controlID::LFOTransportLock, auxAttribute);
+
+	// --- controlID::LFOaBreakpoint .. LFOdBreakpoint
+	auxAttribute.reset(auxGUIIdentifier::guiControlData);
+	auxAttribute.setUintAttribute(1073741824);
+	setParamAuxAttribute(controlID::LFOaBreakpoint, auxAttribute);
+	setParamAuxAttribute(controlID::LFObBreakpoint, auxAttribute);
+	setParamAuxAttribute(controlID::LFOcBreakpoint, auxAttribute);
+	setParamAuxAttribute(controlID::LFOdBreakpoint, auxAttribute);
+
+	// --- controlID::LFOaTrigger .. LFOdTrigger
+	auxAttribute.reset(auxGUIIdentifier::guiControlData);
+	auxAttribute.setUintAttribute(268435456);
+	setParamAuxAttribute(controlID::LFOaTrigger, auxAttribute);
+	setParamAuxAttribute(controlID::LFObTrigger, auxAttribute);
+	setParamAuxAttribute(controlID::LFOcTrigger, auxAttribute);
+	setParamAuxAttribute(controlID::LFOdTrigger, auxAttribute);
+
+	// --- controlID::breakpointCount and the breakpoint points
+	auxAttribute.reset(auxGUIIdentifier::guiControlData);
+	auxAttribute.setUintAttribute(2147483648);
+	setParamAuxAttribute(controlID::breakpointCount, auxAttribute);
+	for (uint32_t i = 0; i < LFO_MAX_BREAKPOINTS; i++)
+	{
+		setParamAuxAttribute(controlID::breakpoint1Phase + i, auxAttribute);
+		setParamAuxAttribute(controlID::breakpoint1Level + i, auxAttribute);
+		setParamAuxAttribute(controlID::breakpoint1Curve + i, auxAttribute);
+	}
+
+	// --- controlID::modSource1..4, modDestination1..4 and modAmount1..4
+	for (uint32_t i = 0; i < AUTOPAN_NUM_MOD_ROUTES; i++)
+	{
+		auxAttribute.reset(auxGUIIdentifier::guiControlData);
+		auxAttribute.setUintAttribute(268435456);
+		setParamAuxAttribute(controlID::modSource1 + i, auxAttribute);
+		setParamAuxAttribute(controlID::modDestination1 + i, auxAttribute);
+
+		auxAttribute.reset(auxGUIIdentifier::guiControlData);
+		auxAttribute.setUintAttribute(2147483648);
+		setParamAuxAttribute(controlID::modAmount1 + i, auxAttribute);
+	}
+
+	// --- controlID::sidechainAttack_mSec, sidechainRelease_mSec
+	auxAttribute.reset(auxGUIIdentifier::guiControlData);
+	auxAttribute.setUintAttribute(2147483648);
+	setParamAuxAttribute(controlID::sidechainAttack_mSec, auxAttribute);
+	setParamAuxAttribute(controlID::sidechainRelease_mSec, auxAttribute);
+
+	// --- controlID::sidechainDetectMode
+	auxAttribute.reset(auxGUIIdentifier::guiControlData);
+	auxAttribute.setUintAttribute(268435456);
+	setParamAuxAttribute(controlID::sidechainDetectMode, auxAttribute);
+
 
 	// **--0xEDA5--**
    
@@ -529,6 +755,10 @@ bool PluginCore::reset(ResetInfo& resetInfo)
 
     // --- other reset inits
 	autoPan.reset(resetInfo.sampleRate);
+	autoPanChanges = AUTOPAN_CHANGED_ALL;
+
+	// --- audio is stopped, so this is a safe place to bring the breakpoint shape up to date
+	compileBreakpointShape();
 
     return PluginBase::reset(resetInfo);
 }
@@ -569,6 +799,192 @@ bool PluginCore::preProcessAudioBuffers(ProcessBufferInfo& processInfo)
     return true;
 }
 
+/**
+\brief buffer-processing method
+
+Operation:
+- AutoPan processes whole non-interleaved buffers, so this override replaces the base class
+  frame marshaling (one virtual call and parameter transfer per sample) with one call per buffer
+- MIDI events are fired up front (see collectMIDIEvents( )); the buffer is split at each note-on,
+  the pieces are processed as blocks and the LFOs are retriggered between them
+- VST3 sample accurate automation splits the buffer too (see planAutomationSubBlocks( )): the
+  automated parameters are moved to their ramp values between pieces and re-cooked once per piece
+- parameter smoothing follows the pieces: while a smoother is moving, the pieces are cut to at most
+  getAutomationRampStep( ) samples and after each one the smoothers advance by its length
+- when every input channel is silent (flagged by the host or detected here) the output is
+  silent too, so AutoPan skips the DSP and only advances its LFOs
+- the host's channel formats are handed to AutoPan every buffer; a surround output switches it
+  from the stereo pan to rotating the input round the speakers
+
+\param processBufferInfo structure of information about *buffer* processing
+
+\return true if operation succeeds, false otherwise
+*/
+bool PluginCore::processAudioBuffers(ProcessBufferInfo& processBufferInfo)
+{
+	// --- sync internal bound variables
+	preProcessAudioBuffers(processBufferInfo);
+
+	// --- fire any MIDI events for this buffer; note-ons become split points
+	collectMIDIEvents(processBufferInfo);
+
+	// --- VST3 sample accurate automation: its split points, and the values for the first piece
+	uint32_t numFrames = processBufferInfo.numFramesToProcess;
+	planAutomationSubBlocks(numFrames);
+	applyAutomationAtFrame(0);
+
+	// --- update GUI params to object
+	bpm = processBufferInfo.hostInfo->dBPM;
+	updateParameters();
+	syncLFOsToTransport(processBufferInfo.hostInfo);
+	autoPan.setUserWavetable(breakpointTables.acquire());
+	autoPan.setChannelFormats(processBufferInfo.channelIOConfig.inputChannelFormat, processBufferInfo.channelIOConfig.outputChannelFormat);
+
+	// --- process the block; silent input is cheap: AutoPan only moves its LFOs along
+	uint32_t numOutputs = processBufferInfo.numAudioOutChannels;
+	uint64_t allOutputs = numOutputs >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << numOutputs) - 1;
+	bool silent = detectInputSilence(processBufferInfo);
+
+	// --- one block per stretch between note-ons and automation split points, cut shorter while a
+	//     smoother is moving; after each piece the smoothers move on by its length, then the
+	//     automation moves, then the LFOs are retriggered
+	bool processed = false;
+	bool smoothing = isSmoothingParameters();
+	uint32_t smoothingStep = getAutomationRampStep();
+	uint32_t startFrame = 0;
+	uint32_t nextRetrigger = 0;
+	uint32_t nextSplit = 0;
+	while (startFrame < numFrames)
+	{
+		uint32_t retriggerFrame = nextRetrigger < numRetriggers ? retriggerOffsets[nextRetrigger] : numFrames;
+		uint32_t splitFrame = nextSplit < numAutomationSplits ? automationSplits[nextSplit] : numFrames;
+		uint32_t endFrame = retriggerFrame < splitFrame ? retriggerFrame : splitFrame;
+		if (smoothing && endFrame - startFrame > smoothingStep)
+			endFrame = startFrame + smoothingStep;
+
+		bool smoothed = false;
+		if (endFrame > startFrame)
+		{
+			processed = processAudioSubBlock(processBufferInfo, startFrame, endFrame - startFrame, silent);
+			if (smoothing)
+			{
+				doSampleAccurateParameterUpdates(endFrame - startFrame);
+				smoothing = isSmoothingParameters();
+				smoothed = true;
+			}
+			startFrame = endFrame;
+		}
+
+		if (splitFrame == endFrame && nextSplit < numAutomationSplits)
+		{
+			applyAutomationAtFrame(endFrame);
+			updateParameters();
+			nextSplit++;
+		}
+		else if (smoothed)
+			updateParameters();
+
+		if (retriggerFrame == endFrame && nextRetrigger < numRetriggers)
+		{
+			autoPan.retriggerLFOs();
+			nextRetrigger++;
+		}
+	}
+
+	// --- stereo: only L/R carry audio
+	uint64_t audibleOutputs = autoPan.isSurroundActive() ? allOutputs : (uint64_t)3;
+	processBufferInfo.outputSilenceFlags = silent ? allOutputs : allOutputs & ~audibleOutputs;
+
+	// --- the object will set its meter value, we just copy it
+	if (processed)
+	{
+		outputMeterL = autoPan.getOutputMeterL();
+		outputMeterR = autoPan.getOutputMeterR();
+	}
+
+	// --- update per-buffer
+	processBufferInfo.hostInfo->uAbsoluteFrameBufferIndex += processBufferInfo.numFramesToProcess;
+	processBufferInfo.hostInfo->dAbsoluteFrameBufferTime += processBufferInfo.numFramesToProcess / audioProcDescriptor.sampleRate;
+
+	// --- send meter data to GUI
+	postProcessAudioBuffers(processBufferInfo);
+
+	return processed;
+}
+
+/**
+\brief fire the buffer's MIDI events ahead of the audio and collect the note-on sample offsets
+
+Operation:
+- the queue only hands events out by sample offset, so it is still asked frame by frame, but only
+  when it holds events and only up to the last of them; a buffer without MIDI costs one call
+- processMIDIEvent( ) fills retriggerOffsets while collectingMIDI is set
+
+\param processBufferInfo structure of information about *buffer* processing
+*/
+void PluginCore::collectMIDIEvents(ProcessBufferInfo& processBufferInfo)
+{
+	numRetriggers = 0;
+
+	IMidiEventQueue* queue = processBufferInfo.midiEventQueue;
+	if (!queue)
+		return;
+
+	uint32_t eventCount = queue->getEventCount();
+	if (eventCount == 0)
+		return;
+
+	collectingMIDI = true;
+	midiEventsFired = 0;
+	for (uint32_t frame = 0; frame < processBufferInfo.numFramesToProcess && midiEventsFired < eventCount; frame++)
+	{
+		midiCollectFrame = frame;
+		queue->fireMidiEvents(frame);
+	}
+	collectingMIDI = false;
+}
+
+/**
+\brief process part of the buffer as a block
+
+\param processBufferInfo structure of information about *buffer* processing
+\param startFrame first frame of the part
+\param numFrames length of the part
+\param silent true if the whole buffer's input is silent
+
+\return true if operation succeeds, false otherwise
+*/
+bool PluginCore::processAudioSubBlock(ProcessBufferInfo& processBufferInfo, uint32_t startFrame, uint32_t numFrames, bool silent)
+{
+	uint32_t numInputs = processBufferInfo.numAudioInChannels < MAX_CHANNEL_COUNT ? processBufferInfo.numAudioInChannels : MAX_CHANNEL_COUNT;
+	uint32_t numOutputs = processBufferInfo.numAudioOutChannels < MAX_CHANNEL_COUNT ? processBufferInfo.numAudioOutChannels : MAX_CHANNEL_COUNT;
+
+	uint32_t numAuxInputs = processBufferInfo.auxInputs ? processBufferInfo.numAuxAudioInChannels : 0;
+	if (numAuxInputs > MAX_CHANNEL_COUNT) numAuxInputs = MAX_CHANNEL_COUNT;
+
+	// --- the whole buffer needs no pointer shuffling
+	const float* const* inputs = processBufferInfo.inputs;
+	float** outputs = processBufferInfo.outputs;
+	const float* const* auxInputs = processBufferInfo.auxInputs;
+	if (startFrame > 0)
+	{
+		for (uint32_t ch = 0; ch < numInputs; ch++)
+			subBlockInputs[ch] = processBufferInfo.inputs[ch] + startFrame;
+		for (uint32_t ch = 0; ch < numOutputs; ch++)
+			subBlockOutputs[ch] = processBufferInfo.outputs[ch] + startFrame;
+		for (uint32_t ch = 0; ch < numAuxInputs; ch++)
+			subBlockAuxInputs[ch] = processBufferInfo.auxInputs[ch] + startFrame;
+		inputs = subBlockInputs;
+		outputs = subBlockOutputs;
+		auxInputs = subBlockAuxInputs;
+	}
+
+	if (silent)
+		return autoPan.processSilentBlock(outputs, numFrames, numOutputs, auxInputs, numAuxInputs);
+
+	return autoPan.processAudioBlock(inputs, outputs, numFrames, numInputs, numOutputs, auxInputs, numAuxInputs);
+}
+
 /**
 \brief frame-processing method
 
@@ -583,8 +999,9 @@ Operation:
 */
 bool PluginCore::processAudioFrame(ProcessFrameInfo& processFrameInfo)
 {
-    // --- fire any MIDI events for this sample interval
-    processFrameInfo.midiEventQueue->fireMidiEvents(processFrameInfo.currentFrame);
+	// --- fire any MIDI events for this sample interval; a note-on retriggers the LFOs before this frame
+	if (processFrameInfo.midiEventQueue)
+		processFrameInfo.midiEventQueue->fireMidiEvents(processFrameInfo.currentFrame);
 
 	// --- do per-frame updates; VST automation and parameter smoothing
 	doSampleAccurateParameterUpdates();
@@ -593,6 +1010,10 @@ bool PluginCore::processAudioFrame(ProcessFrameInfo& processFrameInfo)
 	bpm = processFrameInfo.hostInfo->dBPM;
 
 	updateParameters();
+	syncLFOsToTransport(processFrameInfo.hostInfo);
+	autoPan.setUserWavetable(breakpointTables.acquire());
+	autoPan.setSidechainFrame(processFrameInfo.auxAudioInputFrame, processFrameInfo.numAuxAudioInChannels);
+	autoPan.setChannelFormats(processFrameInfo.channelIOConfig.inputChannelFormat, processFrameInfo.channelIOConfig.outputChannelFormat);
 	// --- panman operates on frames! Our work here is easy!
 	bool processed = autoPan.processAudioFrame(
 		processFrameInfo.audioInputFrame,
@@ -615,60 +1036,241 @@ bool PluginCore::processAudioFrame(ProcessFrameInfo& processFrameInfo)
 }
 
 
+// --- the control IDs and bound variables of each LFO, in AUTOPAN_CHANGED_LFO_A, _B, _C, _D order
+const PluginCore::LFOControlBinding PluginCore::lfoControlBindings[AUTOPAN_NUM_LFOS] =
+{
+	{ { controlID::enableLFOa, controlID::soloLFOa, controlID::LFOaWaveform, controlID::LFOaDepth, controlID::LFOaRate,
+	    controlID::LFOaSyncToBPM, controlID::LFOaPhase, controlID::LFOaBreakpoint, controlID::LFOaTrigger },
+	  &PluginCore::enableLFOa, &PluginCore::soloLFOa, &PluginCore::LFOaWaveform, &PluginCore::LFOaDepth, &PluginCore::LFOaRate,
+	  &PluginCore::LFOaSyncToBPM, &PluginCore::LFOaPhase, &PluginCore::LFOaBreakpoint, &PluginCore::LFOaTrigger },
+	{ { controlID::enableLFOb, controlID::soloLFOb, controlID::LFObWaveform, controlID::LFObDepth, controlID::LFObRate,
+	    controlID::LFObSyncToBPM, controlID::LFObPhase, controlID::LFObBreakpoint, controlID::LFObTrigger },
+	  &PluginCore::enableLFOb, &PluginCore::soloLFOb, &PluginCore::LFObWaveform, &PluginCore::LFObDepth, &PluginCore::LFObRate,
+	  &PluginCore::LFObSyncToBPM, &PluginCore::LFObPhase, &PluginCore::LFObBreakpoint, &PluginCore::LFObTrigger },
+	{ { controlID::enableLFOc, controlID::soloLFOc, controlID::LFOcWaveform, controlID::LFOcDepth, controlID::LFOcRate,
+	    controlID::LFOcSyncToBPM, controlID::LFOcPhase, controlID::LFOcBreakpoint, controlID::LFOcTrigger },
+	  &PluginCore::enableLFOc, &PluginCore::soloLFOc, &PluginCore::LFOcWaveform, &PluginCore::LFOcDepth, &PluginCore::LFOcRate,
+	  &PluginCore::LFOcSyncToBPM, &PluginCore::LFOcPhase, &PluginCore::LFOcBreakpoint, &PluginCore::LFOcTrigger },
+	{ { controlID::enableLFOd, controlID::soloLFOd, controlID::LFOdWaveform, controlID::LFOdDepth, controlID::LFOdRate,
+	    controlID::LFOdSyncToBPM, controlID::LFOdPhase, controlID::LFOdBreakpoint, controlID::LFOdTrigger },
+	  &PluginCore::enableLFOd, &PluginCore::soloLFOd, &PluginCore::LFOdWaveform, &PluginCore::LFOdDepth, &PluginCore::LFOdRate,
+	  &PluginCore::LFOdSyncToBPM, &PluginCore::LFOdPhase, &PluginCore::LFOdBreakpoint, &PluginCore::LFOdTrigger },
+};
+
+// --- the AutoPan group each non-LFO control re-cooks (the LFO controls come from lfoControlBindings);
+//     controls not listed (meters, the breakpoint shape) feed no group
+const PluginCore::AutoPanControlGroup PluginCore::autoPanControlGroups[] =
+{
+	{ controlID::volume_dB, AUTOPAN_CHANGED_VOLUME },
+	{ controlID::panValue, AUTOPAN_CHANGED_PAN }, { controlID::panLawSelector, AUTOPAN_CHANGED_PAN },
+	{ controlID::enableMute, AUTOPAN_CHANGED_ROUTING }, { controlID::enableMSdecode, AUTOPAN_CHANGED_ROUTING },
+	{ controlID::channelSelector, AUTOPAN_CHANGED_ROUTING }, { controlID::stereoWidth, AUTOPAN_CHANGED_ROUTING },
+	{ controlID::LFOControlRateSelector, AUTOPAN_CHANGED_CONTROL_RATE }, { controlID::LFOInterpolationSelector, AUTOPAN_CHANGED_CONTROL_RATE },
+	{ controlID::LFOTransportLock, AUTOPAN_CHANGED_TRANSPORT_LOCK },
+	{ controlID::modSource1, AUTOPAN_CHANGED_MOD_MATRIX }, { controlID::modSource2, AUTOPAN_CHANGED_MOD_MATRIX },
+	{ controlID::modSource3, AUTOPAN_CHANGED_MOD_MATRIX }, { controlID::modSource4, AUTOPAN_CHANGED_MOD_MATRIX },
+	{ controlID::modDestination1, AUTOPAN_CHANGED_MOD_MATRIX }, { controlID::modDestination2, AUTOPAN_CHANGED_MOD_MATRIX },
+	{ controlID::modDestination3, AUTOPAN_CHANGED_MOD_MATRIX }, { controlID::modDestination4, AUTOPAN_CHANGED_MOD_MATRIX },
+	{ controlID::modAmount1, AUTOPAN_CHANGED_MOD_MATRIX }, { controlID::modAmount2, AUTOPAN_CHANGED_MOD_MATRIX },
+	{ controlID::modAmount3, AUTOPAN_CHANGED_MOD_MATRIX }, { controlID::modAmount4, AUTOPAN_CHANGED_MOD_MATRIX },
+	{ controlID::sidechainAttack_mSec, AUTOPAN_CHANGED_SIDECHAIN }, { controlID::sidechainRelease_mSec, AUTOPAN_CHANGED_SIDECHAIN }, { controlID::sidechainDetectMode, AUTOPAN_CHANGED_SIDECHAIN },
+};
+
+/**
+\brief transfer changed GUI controls to the AutoPan object
+
+Operation:
+- postUpdatePluginParameter( ) flags the group of each control that moved; here we copy only
+  those groups into the snapshot and let the object re-cook just those
+- called once per buffer; when nothing changed this is a single atomic exchange
+*/
 void PluginCore::updateParameters()
 {
-	// --- use get/set paradigm to transfer GUI controls to object
-	AutoPanParameters params = autoPan.getParameters();
-	// --- now modify
-
-	params.bpm = bpm;
-
-	params.enableLFOa = (enableLFOa == 1);
-	params.enableLFOb = (enableLFOb == 1);
-	params.enableLFOc = (enableLFOc == 1);
-	params.enableLFOd = (enableLFOd == 1);
-
-	params.soloLFOa = (soloLFOa == 1);
-	params.soloLFOb = (soloLFOb == 1);
-	params.soloLFOc = (soloLFOc == 1);
-	params.soloLFOd = (soloLFOd == 1);
-
-	params.LFOaWaveform = LFOaWaveform;
-	params.LFObWaveform = LFObWaveform;
-	params.LFOcWaveform = LFOcWaveform;
-	params.LFOdWaveform = LFOdWaveform;
-	 
-	params.LFOaDepth = LFOaDepth;
-	params.LFObDepth = LFObDepth;
-	params.LFOcDepth = LFOcDepth;
-	params.LFOdDepth = LFOdDepth;
-
-	params.LFOaRate = LFOaRate;
-	params.LFObRate = LFObRate;
-	params.LFOcRate = LFOcRate;
-	params.LFOdRate = LFOdRate;
-
-	params.LFOaSyncToBPM = LFOaSyncToBPM;
-	params.LFObSyncToBPM = LFObSyncToBPM;
-	params.LFOcSyncToBPM = LFOcSyncToBPM;
-	params.LFOdSyncToBPM = LFOdSyncToBPM;
-
-	params.LFOaPhase = LFOaPhase;
-	params.LFObPhase = LFObPhase;
-	params.LFOcPhase = LFOcPhase;
-	params.LFOdPhase = LFOdPhase;
-
-	params.volume_dB = volume_dB;
-	params.enableMute = (enableMute == 1);
-	params.enableMSdecode = (enableMSdecode == 1);
-	params.channelSelection = convertIntToEnum(channelSelector, channelSelectionEnum);
-	params.panValue = panValue;
-	params.outputMeterL = outputMeterL;
-	params.outputMeterR = outputMeterR;
-	params.stereoWidth = stereoWidth;
-
-	// --- send back to object
-	autoPan.setParameters(params);
+	// --- tempo is host data, not a parameter, so check it here
+	if (autoPanParameters.bpm != bpm)
+		autoPanChanges |= AUTOPAN_CHANGED_TEMPO;
+
+	uint32_t changes = autoPanChanges.exchange(0);
+	if (changes == 0)
+		return;
+
+	AutoPanParameters& params = autoPanParameters;
+
+	if (changes & AUTOPAN_CHANGED_TEMPO)
+		params.bpm = bpm;
+
+	for (uint32_t i = 0; i < AUTOPAN_NUM_LFOS; i++)
+	{
+		if (!(changes & (AUTOPAN_CHANGED_LFO_A << i)))
+			continue;
+
+		const LFOControlBinding& lfo = lfoControlBindings[i];
+		params.LFO[i].enable = (this->*lfo.enable == 1);
+		params.LFO[i].solo = (this->*lfo.solo == 1);
+		params.LFO[i].waveform = this->*lfo.waveform;
+		params.LFO[i].depth = this->*lfo.depth;
+		params.LFO[i].rate = this->*lfo.rate;
+		params.LFO[i].syncToBPM = this->*lfo.syncToBPM;
+		params.LFO[i].phase = this->*lfo.phase;
+		params.LFO[i].breakpointShape = (this->*lfo.breakpoint == 1);
+		params.LFO[i].trigger = convertIntToEnum(this->*lfo.trigger, LFOMode);
+	}
+
+	if (changes & AUTOPAN_CHANGED_VOLUME)
+		params.volume_dB = volume_dB;
+
+	if (changes & AUTOPAN_CHANGED_PAN)
+	{
+		params.panValue = panValue;
+		params.panLaw = convertIntToEnum(panLawSelector, panLawType);
+	}
+
+	if (changes & AUTOPAN_CHANGED_CONTROL_RATE)
+	{
+		// --- selector index -> samples per LFO update
+		const uint32_t controlRates[5] = { 1, 8, 16, 32, 64 };
+		params.LFOControlRate = controlRates[LFOControlRateSelector < 0 ? 0 : LFOControlRateSelector > 4 ? 4 : LFOControlRateSelector];
+		params.LFOInterpolation = convertIntToEnum(LFOInterpolationSelector, modInterpolationType);
+	}
+
+	if (changes & AUTOPAN_CHANGED_TRANSPORT_LOCK)
+		params.lockLFOsToTransport = (LFOTransportLock == 1);
+
+	if (changes & AUTOPAN_CHANGED_MOD_MATRIX)
+	{
+		for (uint32_t i = 0; i < AUTOPAN_NUM_MOD_ROUTES; i++)
+		{
+			params.modRoute[i].source = modSource[i];
+			params.modRoute[i].destination = modDestination[i];
+			params.modRoute[i].amount = modAmount[i];
+		}
+	}
+
+	if (changes & AUTOPAN_CHANGED_SIDECHAIN)
+	{
+		params.sidechain.attackTime_mSec = sidechainAttack_mSec;
+		params.sidechain.releaseTime_mSec = sidechainRelease_mSec;
+		params.sidechain.detectMode = (unsigned int)(sidechainDetectMode < 0 ? 0 : sidechainDetectMode > 2 ? 2 : sidechainDetectMode);
+	}
+
+	if (changes & AUTOPAN_CHANGED_ROUTING)
+	{
+		params.enableMute = (enableMute == 1);
+		params.enableMSdecode = (enableMSdecode == 1);
+		params.channelSelection = convertIntToEnum(channelSelector, channelSelectionEnum);
+		params.stereoWidth = stereoWidth;
+	}
+
+	// --- send to object; it re-cooks only the flagged groups
+	autoPan.setParameters(params, changes);
+}
+
+/**
+\brief hand the host position to AutoPan for its LFO transport lock; AutoPan ignores it when the lock is off
+
+Operation:
+- the musical position is the VST3 projectTimeMusic when the host marks it valid; other hosts
+  only give a sample index, so the position is worked out from it at the current tempo
+
+\param hostInfo host data for this buffer (or frame)
+*/
+void PluginCore::syncLFOsToTransport(HostInfo* hostInfo)
+{
+	if (!hostInfo)
+		return;
+
+	// --- VST3 ProcessContext::kProjectTimeMusicValid
+	const uint32_t projectTimeMusicValid = 1 << 9;
+
+	double quarterNotes = 0.0;
+	if (hostInfo->state & projectTimeMusicValid)
+		quarterNotes = hostInfo->projectTimeMusic;
+	else if (audioProcDescriptor.sampleRate > 0.0)
+		quarterNotes = (double)hostInfo->uAbsoluteFrameBufferIndex / audioProcDescriptor.sampleRate * bpm / 60.0;
+
+	autoPan.syncToTransport(hostInfo->uAbsoluteFrameBufferIndex, quarterNotes);
+}
+
+/**
+\brief true for the controls that make up the breakpoint LFO shape (the point count and every point)
+
+\param controlID the control ID value of the parameter
+*/
+bool PluginCore::isBreakpointControl(int32_t controlID)
+{
+	if (controlID == controlID::breakpointCount)
+		return true;
+
+	for (int32_t first : { (int32_t)controlID::breakpoint1Phase, (int32_t)controlID::breakpoint1Level, (int32_t)controlID::breakpoint1Curve })
+	{
+		if (controlID >= first && controlID < first + (int32_t)LFO_MAX_BREAKPOINTS)
+			return true;
+	}
+	return false;
+}
+
+/**
+\brief compile the breakpoint LFO shape into a table and hand it to the audio thread
+
+Operation:
+- reads the shape from the (atomic) parameter values, not the bound variables, which belong to the audio thread
+- the table is filled in the LFOWavetableExchange's write slot and published with one atomic swap;
+  processAudioBuffers( ) picks it up at the top of the next buffer, so the audio thread never waits
+- called from the GUI thread (guiParameterChanged( ), the GUI timer), from updatePluginParameter( ) for
+  preset and state loads, which need no editor, and from reset( ); never from the audio thread. Calls
+  that overlap another compile just leave the shape flagged for the next one
+*/
+void PluginCore::compileBreakpointShape()
+{
+	if (breakpointShapeCompiling.exchange(true))
+		return;
+
+	// --- clear first: a change made while we compile flags the shape again
+	breakpointShapeDirty = false;
+
+	breakpointShape.setNumPoints((uint32_t)getPIParamValueInt(controlID::breakpointCount));
+	for (uint32_t i = 0; i < LFO_MAX_BREAKPOINTS; i++)
+	{
+		LFOBreakpoint point;
+		point.phase = getPIParamValueDouble(controlID::breakpoint1Phase + i);
+		point.level = getPIParamValueDouble(controlID::breakpoint1Level + i);
+		point.curve = getPIParamValueDouble(controlID::breakpoint1Curve + i);
+		breakpointShape.setPoint(i, point);
+	}
+
+	breakpointShape.compile(breakpointTables.getWriteTable());
+	breakpointTables.publish();
+
+	breakpointShapeCompiling = false;
+}
+
+/**
+\brief build the dense control ID -> AUTOPAN_CHANGED_* lookup; called once, from the constructor, so
+       postUpdatePluginParameter( ) flags a change with one array read
+
+Operation:
+- every control ID in lfoControlBindings row i maps to AUTOPAN_CHANGED_LFO_A << i
+- the other controls come from autoPanControlGroups
+*/
+void PluginCore::initAutoPanChangeFlags()
+{
+	int32_t maxControlID = -1;
+	for (const LFOControlBinding& lfo : lfoControlBindings)
+	{
+		for (int32_t id : lfo.controlIDs)
+			maxControlID = id > maxControlID ? id : maxControlID;
+	}
+	for (const AutoPanControlGroup& group : autoPanControlGroups)
+		maxControlID = group.controlID > maxControlID ? group.controlID : maxControlID;
+
+	autoPanChangeFlags.assign((size_t)(maxControlID + 1), 0);
+	for (uint32_t i = 0; i < AUTOPAN_NUM_LFOS; i++)
+	{
+		for (int32_t id : lfoControlBindings[i].controlIDs)
+			autoPanChangeFlags[id] = AUTOPAN_CHANGED_LFO_A << i;
+	}
+	for (const AutoPanControlGroup& group : autoPanControlGroups)
+		autoPanChangeFlags[group.controlID] = group.changeFlag;
 }
 
 
@@ -697,6 +1299,8 @@ bool PluginCore::postProcessAudioBuffers(ProcessBufferInfo& processInfo)
 Operation:
 - update the parameter's value (with smoothing this initiates another smoothing process)
 - call postUpdatePluginParameter to do any further processing
+- updates that don't come from buffer processing (preset and state loads) compile a changed
+  breakpoint shape right here, so it is ready whether or not the editor is open
 
 \param controlID the control ID value of the parameter being updated
 \param controlValue the new control value
@@ -712,6 +1316,10 @@ bool PluginCore::updatePluginParameter(int32_t controlID, double controlValue, P
     // --- do any post-processing
     postUpdatePluginParameter(controlID, controlValue, paramInfo);
 
+	// --- off the audio thread: compile a changed breakpoint shape now, the editor may not be open
+	if (!paramInfo.bufferProcUpdate && breakpointShapeDirty)
+		compileBreakpointShape();
+
     return true; /// handled
 }
 
@@ -721,6 +1329,7 @@ bool PluginCore::updatePluginParameter(int32_t controlID, double controlValue, P
 Operation:
 - update the parameter's value (with smoothing this initiates another smoothing process)
 - call postUpdatePluginParameter to do any further processing
+- updates that don't come from buffer processing compile a changed breakpoint shape, as updatePluginParameter( )
 
 \param controlID the control ID value of the parameter being updated
 \param normalizedValue the new control value in normalized form
@@ -736,6 +1345,10 @@ bool PluginCore::updatePluginParameterNormalized(int32_t controlID, double norma
 	// --- do any post-processing
 	postUpdatePluginParameter(controlID, controlValue, paramInfo);
 
+	// --- off the audio thread: compile a changed breakpoint shape now, the editor may not be open
+	if (!paramInfo.bufferProcUpdate && breakpointShapeDirty)
+		compileBreakpointShape();
+
 	return true; /// handled
 }
 
@@ -757,18 +1370,21 @@ bool PluginCore::postUpdatePluginParameter(int32_t controlID, double controlValu
     // --- now do any post update cooking; be careful with VST Sample Accurate automation
     //     If enabled, then make sure the cooking functions are short and efficient otherwise disable it
     //     for the Parameter involved
-    /*switch(controlID)
-    {
-        case 0:
-        {
-            return true;    /// handled
-        }
-
-        default:
-            return false;   /// not handled
-    }*/
-
-    return false;
+	//
+	// --- the breakpoint shape is compiled off the audio thread; just note that it changed
+	if (isBreakpointControl(controlID))
+	{
+		breakpointShapeDirty = true;
+		return true;    /// handled
+	}
+
+	// --- we only flag the control's group here; updateParameters( ) does the cooking once per buffer
+	uint32_t changeFlag = getAutoPanChangeFlag(controlID);
+	if (changeFlag == 0)
+		return false;   /// not handled
+
+	autoPanChanges |= changeFlag;
+	return true;    /// handled
 }
 
 /**
@@ -790,6 +1406,13 @@ WARNING:
 */
 bool PluginCore::guiParameterChanged(int32_t controlID, double actualValue)
 {
+	// --- a breakpoint moved on the GUI: compile the new shape here, on the GUI thread
+	if (isBreakpointControl(controlID))
+	{
+		compileBreakpointShape();
+		return true; // handled
+	}
+
 	/*
 	switch (controlID)
 	{
@@ -837,6 +1460,10 @@ bool PluginCore::processMessage(MessageInfo& messageInfo)
 	// --- update view; this will only be called if the GUI is actually open
 	case PLUGINGUI_TIMERPING:
 	{
+		// --- breakpoint shape changed by automation: compile it here, off the audio thread (presets
+		//     compile in updatePluginParameter( ))
+		if (breakpointShapeDirty)
+			compileBreakpointShape();
 		return false;
 	}
 
@@ -879,6 +1506,26 @@ NOTES:
 */
 bool PluginCore::processMIDIEvent(midiEvent& event)
 {
+	if (collectingMIDI)
+		midiEventsFired++;
+
+	// --- only note-ons retrigger the LFOs; velocity 0 is a note-off
+	if (event.midiMessage != MIDI_NOTE_ON || event.midiData2 == 0)
+		return true;
+
+	// --- frame processing (or a host that sends MIDI outside the buffer): retrigger now
+	if (!collectingMIDI)
+	{
+		autoPan.retriggerLFOs();
+		return true;
+	}
+
+	// --- buffer processing: note the split point; chords land on one point
+	if (numRetriggers > 0 && retriggerOffsets[numRetriggers - 1] >= midiCollectFrame)
+		return true;
+	if (numRetriggers < MAX_RETRIGGERS_PER_BUFFER)
+		retriggerOffsets[numRetriggers++] = midiCollectFrame;
+
 	return true;
 }
 
@@ -953,6 +1600,28 @@ bool PluginCore::initPluginPresets()
 	setPresetParameter(preset->presetParameters, controlID::LFObPhase, 0.000000);
 	setPresetParameter(preset->presetParameters, controlID::LFOcPhase, 0.000000);
 	setPresetParameter(preset->presetParameters, controlID::LFOdPhase, 0.000000);
+	setPresetParameter(preset->presetParameters, controlID::panLawSelector, -0.000000);
+	setPresetParameter(preset->presetParameters, controlID::LFOControlRateSelector, 2.000000);
+	setPresetParameter(preset->presetParameters, controlID::LFOInterpolationSelector, -0.000000);
+	setPresetParameter(preset->presetParameters, controlID::LFOTransportLock, -0.000000);
+	setPresetParameter(preset->presetParameters, controlID::LFOaBreakpoint, -0.000000);
+	setPresetParameter(preset->presetParameters, controlID::LFObBreakpoint, -0.000000);
+	setPresetParameter(preset->presetParameters, controlID::LFOcBreakpoint, -0.000000);
+	setPresetParameter(preset->presetParameters, controlID::LFOdBreakpoint, -0.000000);
+	setPresetParameter(preset->presetParameters, controlID::LFOaTrigger, 2.000000);
+	setPresetParameter(preset->presetParameters, controlID::LFObTrigger, 2.000000);
+	setPresetParameter(preset->presetParameters, controlID::LFOcTrigger, 2.000000);
+	setPresetParameter(preset->presetParameters, controlID::LFOdTrigger, 2.000000);
+	setPresetParameter(preset->presetParameters, controlID::breakpointCount, 4.000000);
+	for (uint32_t i = 0; i < AUTOPAN_NUM_MOD_ROUTES; i++)
+	{
+		setPresetParameter(preset->presetParameters, controlID::modSource1 + i, -0.000000);
+		setPresetParameter(preset->presetParameters, controlID::modDestination1 + i, -0.000000);
+		setPresetParameter(preset->presetParameters, controlID::modAmount1 + i, i == 0 ? 1.000000 : 0.000000);
+	}
+	setPresetParameter(preset->presetParameters, controlID::sidechainAttack_mSec, 10.000000);
+	setPresetParameter(preset->presetParameters, controlID::sidechainRelease_mSec, 200.000000);
+	setPresetParameter(preset->presetParameters, controlID::sidechainDetectMode, -0.000000);
 	addPreset(preset);
 
 
@@ -15,6 +15,17 @@
 
 #include "pluginbase.h"
 #include "autopan.h"
+#include "breakpointlfo.h"
+
+// --- MIDI status (midiEvent::midiMessage, channel stripped) that retriggers the LFOs
+const uint32_t MIDI_NOTE_ON = 0x90;
+
+// --- most LFO retriggers (note-ons at different sample offsets) acted on in one buffer; later ones in
+//     the same buffer are applied at the last split point
+const uint32_t MAX_RETRIGGERS_PER_BUFFER = 64;
+
+// --- controls per AutoPan LFO: enable, solo, waveform, depth, rate, sync, phase, breakpoint, trigger
+const uint32_t LFO_CONTROLS_PER_LFO = 9;
 
 
 // **--0x7F1F--**
@@ -57,7 +68,59 @@ enum controlID {
 	LFOaPhase = 6,
 	LFObPhase = 16,
 	LFOcPhase = 26,
-	LFOdPhase = 36
+	LFOdPhase = 36,
+	panLawSelector = 48,
+	LFOControlRateSelector = 49,
+	LFOInterpolationSelector = 50,
+	LFOTransportLock = 51,
+	LFOaBreakpoint = 7,
+	LFObBreakpoint = 17,
+	LFOcBreakpoint = 27,
+	LFOdBreakpoint = 37,
+	LFOaTrigger = 8,
+	LFObTrigger = 18,
+	LFOcTrigger = 28,
+	LFOdTrigger = 38,
+	breakpointCount = 60,
+	breakpoint1Phase = 61,
+	breakpoint2Phase = 62,
+	breakpoint3Phase = 63,
+	breakpoint4Phase = 64,
+	breakpoint5Phase = 65,
+	breakpoint6Phase = 66,
+	breakpoint7Phase = 67,
+	breakpoint8Phase = 68,
+	breakpoint1Level = 71,
+	breakpoint2Level = 72,
+	breakpoint3Level = 73,
+	breakpoint4Level = 74,
+	breakpoint5Level = 75,
+	breakpoint6Level = 76,
+	breakpoint7Level = 77,
+	breakpoint8Level = 78,
+	breakpoint1Curve = 81,
+	breakpoint2Curve = 82,
+	breakpoint3Curve = 83,
+	breakpoint4Curve = 84,
+	breakpoint5Curve = 85,
+	breakpoint6Curve = 86,
+	breakpoint7Curve = 87,
+	breakpoint8Curve = 88,
+	modSource1 = 90,
+	modSource2 = 91,
+	modSource3 = 92,
+	modSource4 = 93,
+	modDestination1 = 100,
+	modDestination2 = 101,
+	modDestination3 = 102,
+	modDestination4 = 103,
+	modAmount1 = 110,
+	modAmount2 = 111,
+	modAmount3 = 112,
+	modAmount4 = 113,
+	sidechainAttack_mSec = 120,
+	sidechainRelease_mSec = 121,
+	sidechainDetectMode = 122
 };
 
 	// **--0x0F1F--**
@@ -107,9 +170,8 @@ public:
 	/** process frames of data */
 	virtual bool processAudioFrame(ProcessFrameInfo& processFrameInfo);
 
-	// --- uncomment and override this for buffer processing; see base class implementation for
-	//     help on breaking up buffers and getting info from processBufferInfo
-	//virtual bool processAudioBuffers(ProcessBufferInfo& processBufferInfo);
+	/** process whole buffers of data; AutoPan runs on blocks so we bypass the base class frame marshaling */
+	virtual bool processAudioBuffers(ProcessBufferInfo& processBufferInfo);
 
 	/** preProcess: do any post-buffer processing required; default operation is to send metering data to GUI  */
 	virtual bool postProcessAudioBuffers(ProcessBufferInfo& processInfo);
@@ -140,10 +202,79 @@ public:
 
 	// --- BEGIN USER VARIABLES AND FUNCTIONS -------------------------------------- //
 	//	   Add your variables and methods here
-	AutoPan autoPan;
-	// --- GUI -> Object transfer function
+	AutoPan<float> autoPan;	///< single precision DSP; the host buffers are float
+	// --- GUI -> Object transfer function; only re-cooks what changed
 	void updateParameters();
 
+	/** map a control ID to the AUTOPAN_CHANGED_* group it belongs to (0 for meters and unknown IDs) */
+	uint32_t getAutoPanChangeFlag(int32_t controlID) const
+	{
+		return controlID >= 0 && (size_t)controlID < autoPanChangeFlags.size() ? autoPanChangeFlags[controlID] : 0;
+	}
+
+	/** fill autoPanChangeFlags from lfoControlBindings and autoPanControlGroups */
+	void initAutoPanChangeFlags();
+
+	/** pass the host position to the AutoPan LFO transport lock */
+	void syncLFOsToTransport(HostInfo* hostInfo);
+
+	/** fire the buffer's MIDI events and note the sample offsets of its note-ons in retriggerOffsets */
+	void collectMIDIEvents(ProcessBufferInfo& processBufferInfo);
+
+	/** run AutoPan over frames [startFrame, startFrame + numFrames) of the buffer */
+	bool processAudioSubBlock(ProcessBufferInfo& processBufferInfo, uint32_t startFrame, uint32_t numFrames, bool silent);
+
+	// --- MIDI retrigger: the buffer is split at the note-ons and the pieces processed as blocks
+	uint32_t retriggerOffsets[MAX_RETRIGGERS_PER_BUFFER] = {};	///< this buffer's note-on sample offsets, ascending, no repeats
+	uint32_t numRetriggers = 0;			///< entries in retriggerOffsets
+	uint32_t midiEventsFired = 0;		///< events the queue delivered during collectMIDIEvents( )
+	uint32_t midiCollectFrame = 0;		///< frame being fired during collectMIDIEvents( )
+	bool collectingMIDI = false;		///< true = processMIDIEvent( ) records note-ons instead of acting on them
+	const float* subBlockInputs[MAX_CHANNEL_COUNT] = {};	///< channel pointers offset into the buffer for processAudioSubBlock( )
+	const float* subBlockAuxInputs[MAX_CHANNEL_COUNT] = {};	///< sidechain channel pointers offset into the buffer for processAudioSubBlock( )
+	float* subBlockOutputs[MAX_CHANNEL_COUNT] = {};			///< channel pointers offset into the buffer for processAudioSubBlock( )
+
+	/** true for the controls that make up the breakpoint LFO shape */
+	static bool isBreakpointControl(int32_t controlID);
+
+	/** compile the breakpoint shape parameters into a table and publish it to the audio thread; never call from the audio thread */
+	void compileBreakpointShape();
+
+	LFOBreakpointCurve breakpointShape;			///< the breakpoint LFO shape, as last compiled
+	LFOWavetableExchange breakpointTables;		///< compiled shapes, GUI thread -> audio thread
+	std::atomic<bool> breakpointShapeDirty{ true };	///< shape parameters changed since the last compile
+	std::atomic<bool> breakpointShapeCompiling{ false };	///< a compile is running (keeps the exchange single-writer)
+
+	/** where the bound variables of one AutoPan LFO live, and their control IDs; lfoControlBindings has a
+	    row per LFO so updateParameters( ) transfers them all with the same code and initAutoPanChangeFlags( )
+	    maps them all to their AUTOPAN_CHANGED_LFO_x group */
+	struct LFOControlBinding
+	{
+		int32_t controlIDs[LFO_CONTROLS_PER_LFO];	///< the control IDs of the nine fields below
+		int PluginCore::*enable;		///< enableLFOx
+		int PluginCore::*solo;			///< soloLFOx
+		int PluginCore::*waveform;		///< LFOxWaveform
+		double PluginCore::*depth;		///< LFOxDepth
+		double PluginCore::*rate;		///< LFOxRate
+		int PluginCore::*syncToBPM;		///< LFOxSyncToBPM
+		int PluginCore::*phase;			///< LFOxPhase
+		int PluginCore::*breakpoint;	///< LFOxBreakpoint
+		int PluginCore::*trigger;		///< LFOxTrigger
+	};
+	static const LFOControlBinding lfoControlBindings[AUTOPAN_NUM_LFOS];	///< LFO 'A', 'B', 'C', 'D'
+
+	/** one row of autoPanControlGroups: a control that is not an LFO's and the AUTOPAN_CHANGED_* group it re-cooks */
+	struct AutoPanControlGroup
+	{
+		int32_t controlID;		///< the control
+		uint32_t changeFlag;	///< its AUTOPAN_CHANGED_* group
+	};
+	static const AutoPanControlGroup autoPanControlGroups[];	///< every other control that feeds the AutoPan object
+	std::vector<uint32_t> autoPanChangeFlags;					///< dense, by control ID; built from lfoControlBindings and autoPanControlGroups
+
+	AutoPanParameters autoPanParameters;	///< snapshot of the latest values sent to autoPan
+	std::atomic<uint32_t> autoPanChanges{ AUTOPAN_CHANGED_ALL };	///< groups changed since the last updateParameters( ); set by postUpdatePluginParameter( )
+
 
 	// --- END USER VARIABLES AND FUNCTIONS -------------------------------------- //
 
@@ -209,6 +340,62 @@ private:
 	int channelSelector = 0;
 	enum class channelSelectorEnum { Stereo,Left,Right };	// to compare: if(compareEnumToInt(channelSelectorEnum::Stereo, channelSelector)) etc... 
 
+	int panLawSelector = 0;
+	enum class panLawSelectorEnum { minus3dB,minus4p5dB,minus6dB,Linear };	// to compare: if(compareEnumToInt(panLawSelectorEnum::minus3dB, panLawSelector)) etc... 
+
+	int LFOControlRateSelector = 2;
+	enum class LFOControlRateSelectorEnum { Full,Every_8,Every_16,Every_32,Every_64 };	// to compare: if(compareEnumToInt(LFOControlRateSelectorEnum::Full, LFOControlRateSelector)) etc... 
+
+	int LFOInterpolationSelector = 0;
+	enum class LFOInterpolationSelectorEnum { Linear,Cubic };	// to compare: if(compareEnumToInt(LFOInterpolationSelectorEnum::Linear, LFOInterpolationSelector)) etc... 
+
+	int LFOTransportLock = 0;
+	enum class LFOTransportLockEnum { SWITCH_OFF,SWITCH_ON };	// to compare: if(compareEnumToInt(LFOTransportLockEnum::SWITCH_OFF, LFOTransportLock)) etc... 
+
+	int LFOaBreakpoint = 0;
+	enum class LFOaBreakpointEnum { SWITCH_OFF,SWITCH_ON };	// to compare: if(compareEnumToInt(LFOaBreakpointEnum::SWITCH_OFF, LFOaBreakpoint)) etc... 
+
+	int LFObBreakpoint = 0;
+	enum class LFObBreakpointEnum { SWITCH_OFF,SWITCH_ON };	// to compare: if(compareEnumToInt(LFObBreakpointEnum::SWITCH_OFF, LFObBreakpoint)) etc... 
+
+	int LFOcBreakpoint = 0;
+	enum class LFOcBreakpointEnum { SWITCH_OFF,SWITCH_ON };	// to compare: if(compareEnumToInt(LFOcBreakpointEnum::SWITCH_OFF, LFOcBreakpoint)) etc... 
+
+	int LFOdBreakpoint = 0;
+	enum class LFOdBreakpointEnum { SWITCH_OFF,SWITCH_ON };	// to compare: if(compareEnumToInt(LFOdBreakpointEnum::SWITCH_OFF, LFOdBreakpoint)) etc... 
+
+	int LFOaTrigger = 2;
+	enum class LFOaTriggerEnum { Retrigger,One_Shot,Free_Run };	// to compare: if(compareEnumToInt(LFOaTriggerEnum::Retrigger, LFOaTrigger)) etc... 
+
+	int LFObTrigger = 2;
+	enum class LFObTriggerEnum { Retrigger,One_Shot,Free_Run };	// to compare: if(compareEnumToInt(LFObTriggerEnum::Retrigger, LFObTrigger)) etc... 
+
+	int LFOcTrigger = 2;
+	enum class LFOcTriggerEnum { Retrigger,One_Shot,Free_Run };	// to compare: if(compareEnumToInt(LFOcTriggerEnum::Retrigger, LFOcTrigger)) etc... 
+
+	int LFOdTrigger = 2;
+	enum class LFOdTriggerEnum { Retrigger,One_Shot,Free_Run };	// to compare: if(compareEnumToInt(LFOdTriggerEnum::Retrigger, LFOdTrigger)) etc... 
+
+	// --- Breakpoint LFO shape; bound only so that changes reach postUpdatePluginParameter( ), the
+	//     shape is compiled off the audio thread from the parameters themselves
+	int breakpointCount = 4;
+	double breakpointPhase[LFO_MAX_BREAKPOINTS] = {};
+	double breakpointLevel[LFO_MAX_BREAKPOINTS] = {};
+	double breakpointCurve[LFO_MAX_BREAKPOINTS] = {};
+
+	// --- Modulation matrix routes: source -> destination x amount
+	int modSource[AUTOPAN_NUM_MOD_ROUTES] = {};
+	enum class modSourceEnum { LFO_Mix,LFO_A,LFO_B,LFO_C,LFO_D,Sidechain };	// to compare: if(compareEnumToInt(modSourceEnum::LFO_Mix, modSource[0])) etc... 
+	int modDestination[AUTOPAN_NUM_MOD_ROUTES] = {};
+	enum class modDestinationEnum { Pan,Width,Volume,LFO_A_Rate,LFO_B_Rate,LFO_C_Rate,LFO_D_Rate,LFO_A_Depth,LFO_B_Depth,LFO_C_Depth,LFO_D_Depth };	// to compare: if(compareEnumToInt(modDestinationEnum::Pan, modDestination[0])) etc... 
+	double modAmount[AUTOPAN_NUM_MOD_ROUTES] = {};
+
+	// --- Sidechain envelope (a modulation source)
+	double sidechainAttack_mSec = 10.0;
+	double sidechainRelease_mSec = 200.0;
+	int sidechainDetectMode = 0;
+	enum class sidechainDetectModeEnum { Peak,MS,RMS };	// to compare: if(compareEnumToInt(sidechainDetectModeEnum::Peak, sidechainDetectMode)) etc... 
+
 	// --- Meter Plugin Variables
 	float outputMeterL = 0.f;
 	float outputMeterR = 0.f;
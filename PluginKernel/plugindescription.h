@@ -61,7 +61,7 @@ const int32_t kManufacturerID = 'VNDR';
 const int32_t kAAXProductID = 'asdd';
 
 // --- Plugin Options
-const bool kWantSidechain = false;
+const bool kWantSidechain = true;
 const uint32_t kLatencyInSamples = 0;
 const double kTailTimeMsec = 0.000;
 const bool kVSTInfiniteTail = false;
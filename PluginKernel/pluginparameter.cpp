@@ -40,7 +40,7 @@ PluginParameter::PluginParameter(int _controlID, const char* _controlName, const
 {
     setControlValue(_defaultValue);
     setSmoothedTargetValue(_defaultValue);
-    useParameterSmoothing = false;
+    liveState->useParameterSmoothing = false;
     setIsWritable(false);
 }
 
@@ -68,7 +68,7 @@ PluginParameter::PluginParameter(int _controlID, const char* _controlName, std::
         setDefaultValue((double)defaultStringIndex);
         setControlValue((double)defaultStringIndex);
     }
-    useParameterSmoothing = false;
+    liveState->useParameterSmoothing = false;
     setIsWritable(false);
     setCommaSeparatedStringList();
 }
@@ -108,7 +108,7 @@ PluginParameter::PluginParameter(int _controlID, const char* _controlName, const
         setDefaultValue((double)defaultStringIndex);
         setControlValue((double)defaultStringIndex);
     }
-    useParameterSmoothing = false;
+    liveState->useParameterSmoothing = false;
     setIsWritable(false);
     setCommaSeparatedStringList();
 }
@@ -140,7 +140,7 @@ PluginParameter::PluginParameter(int _controlID, const char* _controlName, doubl
     setSmoothedTargetValue(0.0);
 
     setControlVariableType(controlVariableType::kMeter);
-    useParameterSmoothing = false;
+    liveState->useParameterSmoothing = false;
     setIsWritable(true);
 }
 
@@ -159,7 +159,7 @@ PluginParameter::PluginParameter(int _controlID, const char* _controlName, contr
     setControlValue(0.0);
     setSmoothedTargetValue(0.0);
 
-    useParameterSmoothing = false;
+    liveState->useParameterSmoothing = false;
     setIsWritable(false);
 }
 
@@ -171,7 +171,7 @@ PluginParameter::PluginParameter()
     setControlValue(0.0);
     setSmoothedTargetValue(0.0);
 
-    useParameterSmoothing = false;
+    liveState->useParameterSmoothing = false;
     setIsWritable(false);
 }
 
@@ -189,11 +189,11 @@ PluginParameter::PluginParameter(const PluginParameter& initGuiControl)
     minValue = initGuiControl.minValue;
     maxValue = initGuiControl.maxValue;
     defaultValue = initGuiControl.defaultValue;
-    controlValueAtomic = initGuiControl.getAtomicControlValueFloat();
+    liveState->controlValueAtomic = initGuiControl.getAtomicControlValueFloat();
     controlTaper = initGuiControl.controlTaper;
     displayPrecision = initGuiControl.displayPrecision;
     stringList = initGuiControl.stringList;
-    useParameterSmoothing = initGuiControl.useParameterSmoothing;
+    liveState->useParameterSmoothing = initGuiControl.liveState->useParameterSmoothing;
     smoothingType = initGuiControl.smoothingType;
     smoothingTimeMsec = initGuiControl.smoothingTimeMsec;
     meterAttack_ms = initGuiControl.meterAttack_ms;
@@ -217,6 +217,9 @@ PluginParameter::~PluginParameter()
 	}
 
 	auxAttributeMap.clear();
+
+	if (ownsLiveState)
+		delete liveState;
 }
 
 /**
@@ -26,6 +26,153 @@
 #include "guiconstants.h"
 
 
+/**
+\struct ParameterLiveState
+\ingroup ASPiK-Core
+\brief
+The part of a PluginParameter that the audio thread works on every buffer: the atomic control value, the smoothing
+target and smoother, the bound variable and the dirty bitmask hook-up. Everything else about a parameter (name, units,
+string list, range, aux attributes) is only read off the audio thread and stays in the PluginParameter.
+
+A PluginParameter starts out with a live state of its own. PluginBase::initPluginParameterArray( ) moves the live states
+of all of its parameters into one contiguous, cache-line aligned array, so that syncInBoundVariables( ) and the smoothing
+loop stream through memory instead of visiting the scattered PluginParameter objects.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+struct ParameterLiveState
+{
+	ParameterLiveState() {}
+	ParameterLiveState(const ParameterLiveState& state) { *this = state; }	///< atomics are not copyable, so copy by hand
+
+	/** copy everything; the atomics are copied by value */
+	ParameterLiveState& operator=(const ParameterLiveState& state)
+	{
+		if (this == &state)
+			return *this;
+
+		controlValueAtomic.store(state.controlValueAtomic.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		smoothedTargetValueAtomic.store(state.smoothedTargetValueAtomic.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		controlID = state.controlID;
+		useParameterSmoothing = state.useParameterSmoothing;
+		paramSmoother = state.paramSmoother;
+		boundVariableUInt = state.boundVariableUInt;
+		boundVariableInt = state.boundVariableInt;
+		boundVariableFloat = state.boundVariableFloat;
+		boundVariableDouble = state.boundVariableDouble;
+		dirtyFlagsWord = state.dirtyFlagsWord;
+		dirtySummaryWord = state.dirtySummaryWord;
+		dirtyFlagMask = state.dirtyFlagMask;
+		dirtySummaryMask = state.dirtySummaryMask;
+		return *this;
+	}
+
+	/** the control value */
+	double getControlValue() const { return (double)controlValueAtomic.load(std::memory_order_relaxed); }
+
+	/** write the control value and flag it in the dirty bitmask; for writes from outside the audio thread */
+	void setControlValue(double value) { storeControlValue(value); markDirty(); }
+
+	/** write the control value without flagging it; for the audio thread's smoothing and automation, which
+	    update the bound variable and post the change themselves, so the next sync has nothing to repeat */
+	void storeControlValue(double value) { controlValueAtomic.store((float)value, std::memory_order_relaxed); }
+
+	/** flag the value as written; the release pairs with the sync's acquire so the value is seen with the bit */
+	void markDirty()
+	{
+		if (!dirtyFlagsWord) return;
+		dirtyFlagsWord->fetch_or(dirtyFlagMask, std::memory_order_release);
+		dirtySummaryWord->fetch_or(dirtySummaryMask, std::memory_order_release);
+	}
+
+	/**
+	\brief perform smoothing operation on data
+
+	\return true if data was actually smoothed, false otherwise (data that has reached its terminal value will not be smoothed any further)
+	*/
+	bool smoothParameterValue()
+	{
+		if (!useParameterSmoothing) return false;
+		double smoothedValue = 0.0;
+		bool smoothed = paramSmoother.smoothParameter((double)smoothedTargetValueAtomic.load(), smoothedValue);
+		if (smoothed)
+			storeControlValue(smoothedValue);
+		return smoothed;
+	}
+
+	/**
+	\brief advance the smoother a block of samples in one go (ParamSmoother::advance( ), O(1)); the value
+	becomes the smoothed value at the end of the block. A smoother that has arrived costs one compare
+
+	\param numSamples samples to advance
+	\return true if the value moved, false if smoothing is off or has converged
+	*/
+	bool smoothParameterBlock(uint32_t numSamples)
+	{
+		double target = (double)smoothedTargetValueAtomic.load();
+		if (!useParameterSmoothing || numSamples == 0 || paramSmoother.isConverged(target))
+			return false;
+
+		storeControlValue(paramSmoother.advance(target, numSamples));
+		return true;
+	}
+
+	/** true while the smoother is still moving towards its target; O(1) */
+	bool isSmoothing() const { return useParameterSmoothing && !paramSmoother.isConverged((double)smoothedTargetValueAtomic.load()); }
+
+	/**
+	\brief perform the variable binding update (change the value)
+
+	\return true if the bound variable's value actually changed, false if it already held the value (or there is no binding)
+	*/
+	bool updateInBoundVariable()
+	{
+		if (boundVariableUInt)
+			return writeBoundVariable(*boundVariableUInt, (uint32_t)getControlValue());
+		else if (boundVariableInt)
+			return writeBoundVariable(*boundVariableInt, (int)getControlValue());
+		else if (boundVariableFloat)
+			return writeBoundVariable(*boundVariableFloat, (float)getControlValue());
+		else if (boundVariableDouble)
+			return writeBoundVariable(*boundVariableDouble, getControlValue());
+		return false;
+	}
+
+	/** write a bound variable, reporting whether its value changed */
+	template <typename T>
+	static bool writeBoundVariable(T& boundVariable, T value)
+	{
+		if (boundVariable == value)
+			return false;
+		boundVariable = value;
+		return true;
+	}
+
+	// --- *the* control value
+	// --- atomic float as control value
+	//     atomic double will not behave properly between 32/64 bit
+	std::atomic<float> controlValueAtomic{ 0.f };			///< the underlying atomic variable
+	std::atomic<float> smoothedTargetValueAtomic{ 0.f };	///< the underlying atomic variable TARGET for smoothing
+	int controlID = -1;										///< copy of the parameter's ID, for postUpdatePluginParameter( )
+	bool useParameterSmoothing = false;						///< enable param smoothing
+	ParamSmoother<double> paramSmoother;					///< param smoothing object
+
+	// --- for variable-binding support
+	uint32_t* boundVariableUInt = nullptr;			///< bound variable as UINT
+	int* boundVariableInt = nullptr;				///< bound variable as int
+	float* boundVariableFloat = nullptr;			///< bound variable as float
+	double* boundVariableDouble = nullptr;			///< bound variable as double
+
+	// --- dirty bitmask, see PluginParameter::setDirtyFlags( )
+	std::atomic<uint64_t>* dirtyFlagsWord = nullptr;	///< PluginBase bitmask word holding our bit; null = not hooked up
+	std::atomic<uint64_t>* dirtySummaryWord = nullptr;	///< PluginBase summary word holding our word's bit
+	uint64_t dirtyFlagMask = 0;							///< our bit
+	uint64_t dirtySummaryMask = 0;						///< our word's bit
+};
+
 /**
 \class PluginParameter
 \ingroup ASPiK-Core
@@ -39,7 +186,7 @@ PluginParameter Operations:
 - store attributes of plugin parameters (numerous)
 - store the actual parameter value as an atomic double
 - provide access to the atomic double value as needed (and safely)
-- hold the parameter smoother object
+- hold the parameter smoother object (in its ParameterLiveState)
 - store infinite amount of auxilliary data in numerous formats (you can easily add your own)
 - consists mainly of attributes and get/set functions for each
 
@@ -78,8 +225,8 @@ public:
 	/** D-TOR */
     virtual ~PluginParameter();
 
-    uint32_t getControlID() { return controlID; }			///< get ID value
-    void setControlID(uint32_t cid) { controlID = cid; }	///< set ID value
+    uint32_t getControlID() { return controlID; }										///< get ID value
+    void setControlID(uint32_t cid) { controlID = cid; liveState->controlID = cid; }	///< set ID value
 
     const char* getControlName() { return controlName.c_str(); }			///< get name as const char*
     void setControlName(const char* name) { controlName.assign(name); }		///< set name as const char*
@@ -140,8 +287,8 @@ public:
 	bool isProtoolsGRMeter() { return protoolsGRMeter; }				///< query pro tools GR meter flag
 	void setIsProtoolsGRMeter(bool value) { protoolsGRMeter = value; }	///< set inverted meter flag
 
-	bool getParameterSmoothing() { return useParameterSmoothing; }				///< query parameter smoothing flag
-    void setParameterSmoothing(bool value) { useParameterSmoothing = value; }	///< set inverted meter flag
+	bool getParameterSmoothing() { return liveState->useParameterSmoothing; }				///< query parameter smoothing flag
+    void setParameterSmoothing(bool value) { liveState->useParameterSmoothing = value; }	///< set inverted meter flag
 
     double getSmoothingTimeMsec() { return smoothingTimeMsec;}					///< query smoothing time
     void setSmoothingTimeMsec(double value) { smoothingTimeMsec = value; }		///< set inverted meter flag
@@ -177,7 +324,7 @@ public:
 		if (controlType == controlVariableType::kDouble ||
 			controlType == controlVariableType::kFloat)
 		{
-			if (useParameterSmoothing && !ignoreSmoothing)
+			if (liveState->useParameterSmoothing && !ignoreSmoothing)
 				setSmoothedTargetValue(actualParamValue);
 			else
 				setAtomicControlValueDouble(actualParamValue);
@@ -201,7 +348,7 @@ public:
 		if (controlType == controlVariableType::kDouble ||
 			controlType == controlVariableType::kFloat)
 		{
-			if (useParameterSmoothing && !ignoreParameterSmoothing)
+			if (liveState->useParameterSmoothing && !ignoreParameterSmoothing)
 				setSmoothedTargetValue(actualParamValue);
 			else
 				setAtomicControlValueDouble(actualParamValue);
@@ -212,6 +359,22 @@ public:
 		return actualParamValue;
 	}
 
+	/**
+	\brief audio thread: set the value from a normalized value, skipping smoothing and the dirty bitmask; for
+	       sample accurate automation, which updates the bound variable and posts the change itself
+
+	\param normalizedValue parameter value as a regular double
+	\param applyTaper add the control taper during the operation
+
+	\return the actual value
+	*/
+	inline double storeControlValueNormalized(double normalizedValue, bool applyTaper = true)
+	{
+		double actualParamValue = getControlValueWithNormalizedValue(normalizedValue, applyTaper);
+		liveState->storeControlValue(actualParamValue);
+		return actualParamValue;
+	}
+
 	/**
 	\brief the main function to access the underlying atomic double value as a string
 
@@ -410,7 +573,7 @@ public:
 	*/
 	void initParamSmoother(double sampleRate)
     {
-        paramSmoother.initParamSmoother(smoothingTimeMsec,
+        liveState->paramSmoother.initParamSmoother(smoothingTimeMsec,
                                         sampleRate,
                                         getAtomicControlValueDouble(),
                                         minValue,
@@ -425,7 +588,7 @@ public:
 	*/
 	void updateSampleRate(double sampleRate)
     {
-        paramSmoother.setSampleRate(sampleRate);
+        liveState->paramSmoother.setSampleRate(sampleRate);
     }
 
 	/**
@@ -433,15 +596,7 @@ public:
 
 	\return true if data was actually smoothed, false otherwise (data that has reached its terminal value will not be smoothed any further)
 	*/
-	bool smoothParameterValue()
-    {
-        if(!useParameterSmoothing) return false;
-        double smoothedValue = 0.0;
-        bool smoothed = paramSmoother.smoothParameter(getSmoothedTargetValue(), smoothedValue);
-        if(smoothed)
-			setAtomicControlValueDouble(smoothedValue);
-        return smoothed;
-    }
+	bool smoothParameterValue() { return liveState->smoothParameterValue(); }
 
 	/**
 	\brief save the variable for binding operation
@@ -454,13 +609,13 @@ public:
 		boundVariableDataType = dataType;
 
         if(dataType == boundVariableType::kDouble)
-            boundVariableDouble = (double*)boundVariable;
+            liveState->boundVariableDouble = (double*)boundVariable;
         else if(dataType == boundVariableType::kFloat)
-            boundVariableFloat = (float*)boundVariable;
+            liveState->boundVariableFloat = (float*)boundVariable;
         else if(dataType == boundVariableType::kInt)
-            boundVariableInt = (int*)boundVariable;
+            liveState->boundVariableInt = (int*)boundVariable;
         else if(dataType == boundVariableType::kUInt)
-            boundVariableUInt = (uint32_t*)boundVariableUInt;
+            liveState->boundVariableUInt = (uint32_t*)liveState->boundVariableUInt;
 
 		// --- initialize it
 		updateInBoundVariable();
@@ -476,32 +631,9 @@ public:
 	/**
 	\brief perform the variable binding update (change the value)
 
-	\return boundVariableType
+	\return true if the bound variable's value actually changed, false if it already held the value (or there is no binding)
 	*/
-	bool updateInBoundVariable()
-	{
-		if (boundVariableUInt)
-		{
-			*boundVariableUInt = (uint32_t)getControlValue();
-			return true;
-		}
-		else if (boundVariableInt)
-		{
-			*boundVariableInt = (int)getControlValue();
-			return true;
-		}
-		else if (boundVariableFloat)
-		{
-			*boundVariableFloat = (float)getControlValue();
-			return true;
-		}
-		else if (boundVariableDouble)
-		{
-			*boundVariableDouble = getControlValue();
-			return true;
-		}
-		return false;
-	}
+	bool updateInBoundVariable() { return liveState->updateInBoundVariable(); }
 
 	/**
 	\brief perform the variable binding update on meter data
@@ -510,24 +642,24 @@ public:
 	*/
 	bool updateOutBoundVariable()
 	{
-		if (boundVariableUInt)
+		if (liveState->boundVariableUInt)
 		{
-			setControlValue((double)*boundVariableUInt);
+			setControlValue((double)*liveState->boundVariableUInt);
 			return true;
 		}
-		else if (boundVariableInt)
+		else if (liveState->boundVariableInt)
 		{
-			setControlValue((double)*boundVariableInt);
+			setControlValue((double)*liveState->boundVariableInt);
 			return true;
 		}
-		else if (boundVariableFloat)
+		else if (liveState->boundVariableFloat)
 		{
-			setControlValue((double)*boundVariableFloat);
+			setControlValue((double)*liveState->boundVariableFloat);
 			return true;
 		}
-		else if (boundVariableDouble)
+		else if (liveState->boundVariableDouble)
 		{
-			setControlValue(*boundVariableDouble);
+			setControlValue(*liveState->boundVariableDouble);
 			return true;
 		}
 		return false;
@@ -547,6 +679,45 @@ public:
 	*/
 	IParameterUpdateQueue* getParameterUpdateQueue() { return parameterUpdateQueue; } // may be NULL - that is OK
 
+	/**
+	\brief hooks the parameter into the PluginBase dirty bitmask: every write to the control value, from any thread,
+	sets this parameter's bit so that syncInBoundVariables( ) only visits the parameters that were written
+
+	\param _dirtyFlagsWord the bitmask word holding this parameter's bit
+	\param _dirtySummaryWord the summary word holding the bit for that word
+	\param wordBit this parameter's bit in _dirtyFlagsWord
+	\param summaryBit the bit for _dirtyFlagsWord in _dirtySummaryWord
+	*/
+	void setDirtyFlags(std::atomic<uint64_t>* _dirtyFlagsWord, std::atomic<uint64_t>* _dirtySummaryWord, uint32_t wordBit, uint32_t summaryBit)
+	{
+		liveState->dirtyFlagsWord = _dirtyFlagsWord;
+		liveState->dirtySummaryWord = _dirtySummaryWord;
+		liveState->dirtyFlagMask = (uint64_t)1 << wordBit;
+		liveState->dirtySummaryMask = (uint64_t)1 << summaryBit;
+	}
+
+	/**
+	\brief move the parameter's live state (value, smoother, bound variable) into storage owned by someone else; PluginBase
+	uses this to gather the live states of all parameters into one array. The storage must outlive the parameter.
+
+	\param state the new home of the live state; the current state is copied into it
+	*/
+	void setLiveState(ParameterLiveState* state)
+	{
+		if (!state || state == liveState)
+			return;
+
+		*state = *liveState;
+		state->controlID = controlID;
+		if (ownsLiveState)
+			delete liveState;
+		liveState = state;
+		ownsLiveState = false;
+	}
+
+	/** the live state, see ParameterLiveState */
+	ParameterLiveState* getLiveState() { return liveState; }
+
 	/** overloaded = operator (standard C++ fare) */
 	PluginParameter& operator=(const PluginParameter& aPluginParameter)	// need this override for collections to work
 	{
@@ -562,10 +733,10 @@ public:
 		maxValue = aPluginParameter.maxValue;
 		defaultValue = aPluginParameter.defaultValue;
 		controlTaper = aPluginParameter.controlTaper;
-		controlValueAtomic = aPluginParameter.getAtomicControlValueFloat();
+		liveState->controlValueAtomic = aPluginParameter.getAtomicControlValueFloat();
 		displayPrecision = aPluginParameter.displayPrecision;
 		stringList = aPluginParameter.stringList;
-		useParameterSmoothing = aPluginParameter.useParameterSmoothing;
+		liveState->useParameterSmoothing = aPluginParameter.liveState->useParameterSmoothing;
 		smoothingType = aPluginParameter.smoothingType;
 		smoothingTimeMsec = aPluginParameter.smoothingTimeMsec;
 		meterAttack_ms = aPluginParameter.meterAttack_ms;
@@ -590,20 +761,18 @@ protected:
     double maxValue = 1.0;			///< the max for the parameter
     double defaultValue = 0.0;		///< the default value for the parameter
 
-    // --- *the* control value
-    // --- atomic float as control value
-    //     atomic double will not behave properly between 32/64 bit
-    std::atomic<float> controlValueAtomic;		///< the underlying atomic variable
+    // --- *the* control value, smoother and bound variable live here; see ParameterLiveState
+    ParameterLiveState* liveState = new ParameterLiveState;	///< our own, or a slot in the PluginBase array after setLiveState( )
+    bool ownsLiveState = true;								///< true = liveState is ours to delete
 
-    float getAtomicControlValueFloat() const { return controlValueAtomic.load(std::memory_order_relaxed); }			///< set atomic variable with float
-	void setAtomicControlValueFloat(float value) { controlValueAtomic.store(value, std::memory_order_relaxed); }	///< get atomic variable as float
+    float getAtomicControlValueFloat() const { return liveState->controlValueAtomic.load(std::memory_order_relaxed); }	///< set atomic variable with float
+	void setAtomicControlValueFloat(float value) { liveState->setControlValue(value); }									///< get atomic variable as float
 
-    double getAtomicControlValueDouble() const { return (double)controlValueAtomic.load(std::memory_order_relaxed); }		///< set atomic variable with double
-	void setAtomicControlValueDouble(double value) { controlValueAtomic.store((float)value, std::memory_order_relaxed); }	///< get atomic variable as double
+    double getAtomicControlValueDouble() const { return liveState->getControlValue(); }		///< set atomic variable with double
+	void setAtomicControlValueDouble(double value) { liveState->setControlValue(value); }	///< get atomic variable as double
 
-    std::atomic<float> smoothedTargetValueAtomic;	///< the underlying atomic variable TARGET for smoothing
-    void setSmoothedTargetValue(double value){ smoothedTargetValueAtomic.store((float)value); }	///< set atomic TARGET smoothing variable with double
-    double getSmoothedTargetValue() const { return (double)smoothedTargetValueAtomic.load(); }	///< set atomic TARGET smoothing variable with double
+    void setSmoothedTargetValue(double value){ liveState->smoothedTargetValueAtomic.store((float)value); }	///< set atomic TARGET smoothing variable with double
+    double getSmoothedTargetValue() const { return (double)liveState->smoothedTargetValueAtomic.load(); }	///< set atomic TARGET smoothing variable with double
 
     // --- control tweakers
     taper controlTaper = taper::kLinearTaper;	///< the taper
@@ -627,10 +796,8 @@ protected:
 	bool protoolsGRMeter = false;				///< meter is a Pro Tools gain reduction meter
 
     // --- parameter smoothing
-    bool useParameterSmoothing = false;			///< enable param smoothing
     smoothingMethod smoothingType = smoothingMethod::kLPFSmoother;	///< param smoothing type
     double smoothingTimeMsec = 100.0;			///< param smoothing time
-    ParamSmoother<double> paramSmoother;		///< param smoothing object
 
 	// --- variable binding
 	boundVariableType boundVariableDataType = boundVariableType::kFloat;	///< bound data type
@@ -768,12 +935,6 @@ protected:
     }
 
 private:
-    // --- for variable-binding support
-    uint32_t* boundVariableUInt = nullptr;			///< bound variable as UINT
-    int* boundVariableInt = nullptr;				///< bound variable as int
-    float* boundVariableFloat = nullptr;			///< bound variable as float
-    double* boundVariableDouble = nullptr;			///< bound variable as double
-
 	typedef std::map<uint32_t, AuxParameterAttribute*> auxParameterAttributeMap; ///< Aux attributes that can be stored on this object (similar to VSTGUI4) makes it easy to add extra data in the future
 	auxParameterAttributeMap auxAttributeMap;		///< map of aux attributes
 
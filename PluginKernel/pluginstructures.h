@@ -1094,6 +1094,11 @@ struct ProcessBufferInfo
 	// --- should make these const?
     HostInfo* hostInfo = nullptr;			///< pointer to host data for this buffer
     IMidiEventQueue* midiEventQueue = nullptr;	///< MIDI event queue
+
+	// --- silence flags: bit n is set when channel n is all zeros for the whole buffer;
+	//     only the first 64 channels can be flagged (same layout as VST3 silenceFlags)
+	uint64_t inputSilenceFlags = 0;		///< set fresh each buffer by hosts that know; read-only to the plugin (see PluginBase::detectInputSilence( ))
+	uint64_t outputSilenceFlags = 0;	///< set by the plugin for output channels it wrote as silence
 };
 
 /**
@@ -1593,6 +1598,14 @@ public:
 	/**    Get the sample-accurate value of the parameter at the next sample offset, determined by an internal counter
 	//     Returns true if dNextValue is different than the previous value */
 	virtual bool getNextValue(double& _nextValue) = 0;
+
+	/**    Get the number of automation points in this buffer (VST3 IParamValueQueue::getPointCount( ))
+	//     Returns -1 if the queue can only be polled with getNextValue( ); the base class can't list its points */
+	virtual int32_t getPointCount() { return -1; }
+
+	/**    Get one automation point: its sample offset in the buffer and its normalized value; points are in offset order
+	//     Returns true if the point exists */
+	virtual bool getPoint(int32_t _index, uint32_t& _sampleOffset, double& _value) { return false; }
 };
 
 // --------------------------------------------------------------------------------------------------------------------------- //
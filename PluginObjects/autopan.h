@@ -5,6 +5,10 @@
 
 #include "fxobjects.h"
 #include "superlfo.h"
+#include "panlaw.h"
+#include "temposync.h"
+#include "modmatrix.h"
+#include "vbap.h"
 
 
 #define _kSIN 0
@@ -17,6 +21,110 @@
 #define kINVERTED_PHASE 2
 #define kQUAD_INVERTED_PHASE 3
 
+// --- number of LFOs in the modulation section; the bank takes up to 16
+const uint32_t AUTOPAN_NUM_LFOS = 4;
+
+// --- change flags for AutoPan::setParameters( ); each bit marks a group of
+//     parameters that needs re-cooking; bits 0-15 are the LFOs, one per lane
+const uint32_t AUTOPAN_CHANGED_LFO_A = 1 << 0;	///< any LFO 'A' control (rate, sync, depth, waveform, phase, enable, solo)
+const uint32_t AUTOPAN_CHANGED_LFO_B = 1 << 1;	///< any LFO 'B' control
+const uint32_t AUTOPAN_CHANGED_LFO_C = 1 << 2;	///< any LFO 'C' control
+const uint32_t AUTOPAN_CHANGED_LFO_D = 1 << 3;	///< any LFO 'D' control
+const uint32_t AUTOPAN_CHANGED_LFOS = 0xFFFF;	///< any LFO
+const uint32_t AUTOPAN_CHANGED_TEMPO = 1 << 16;	///< host BPM; only re-cooks tempo-synced LFOs
+const uint32_t AUTOPAN_CHANGED_VOLUME = 1 << 17;	///< volume_dB
+const uint32_t AUTOPAN_CHANGED_PAN = 1 << 18;	///< panValue, panLaw
+const uint32_t AUTOPAN_CHANGED_ROUTING = 1 << 19;	///< mute, M/S decode, channel selection, stereo width
+const uint32_t AUTOPAN_CHANGED_CONTROL_RATE = 1 << 20;	///< LFO control rate and interpolation
+const uint32_t AUTOPAN_CHANGED_TRANSPORT_LOCK = 1 << 21;	///< LFO transport lock on/off
+const uint32_t AUTOPAN_CHANGED_MOD_MATRIX = 1 << 22;	///< modulation routes
+const uint32_t AUTOPAN_CHANGED_SIDECHAIN = 1 << 23;	///< sidechain detector attack, release and mode
+const uint32_t AUTOPAN_CHANGED_ALL = 0xFFFFFF;
+
+// --- processAudioBlock( ) renders the LFO modulation in chunks of this many samples
+const uint32_t AUTOPAN_MOD_CHUNK = 64;
+
+// --- modulation matrix sources: the LFO mix (the average of the audible LFOs, the classic AutoPan
+//     pan modulation), then each LFO on its own (depth and polarity applied, not averaged), then the
+//     sidechain envelope (0.0 to 1.0)
+const uint32_t AUTOPAN_MOD_SOURCE_LFO_MIX = 0;
+const uint32_t AUTOPAN_MOD_SOURCE_LFO = 1;	///< + LFO index
+const uint32_t AUTOPAN_MOD_SOURCE_SIDECHAIN = AUTOPAN_MOD_SOURCE_LFO + AUTOPAN_NUM_LFOS;
+const uint32_t AUTOPAN_NUM_MOD_SOURCES = AUTOPAN_MOD_SOURCE_SIDECHAIN + 1;
+
+// --- modulation matrix destinations
+const uint32_t AUTOPAN_MOD_DEST_PAN = 0;
+const uint32_t AUTOPAN_MOD_DEST_WIDTH = 1;
+const uint32_t AUTOPAN_MOD_DEST_VOLUME = 2;
+const uint32_t AUTOPAN_MOD_DEST_LFO_RATE = 3;	///< + LFO index
+const uint32_t AUTOPAN_MOD_DEST_LFO_DEPTH = AUTOPAN_MOD_DEST_LFO_RATE + AUTOPAN_NUM_LFOS;	///< + LFO index
+const uint32_t AUTOPAN_NUM_MOD_DESTINATIONS = AUTOPAN_MOD_DEST_LFO_DEPTH + AUTOPAN_NUM_LFOS;
+
+// --- number of route slots in AutoPanParameters
+const uint32_t AUTOPAN_NUM_MOD_ROUTES = 4;
+
+// --- what a modulation of 1.0 means at each destination
+const double kAutoPanModWidthRange = 100.0;		///< % of stereo width
+const double kAutoPanModVolumeRange_dB = 24.0;	///< dB of volume
+const double kAutoPanModRateRange = 2.0;		///< octaves of LFO rate; LFO depth is scaled by 1 + modulation
+
+// --- the sidechain source maps the detected level from -kAutoPanSidechainRange_dB (0.0) to 0 dBFS (1.0)
+const double kAutoPanSidechainRange_dB = 60.0;
+
+/**
+\struct AutoPanModRoute
+\ingroup FX-Objects
+\brief
+One modulation matrix route: AUTOPAN_MOD_SOURCE_* to AUTOPAN_MOD_DEST_* scaled by amount; 0.0 is no route.
+*/
+struct AutoPanModRoute
+{
+	int source = AUTOPAN_MOD_SOURCE_LFO_MIX;	///< AUTOPAN_MOD_SOURCE_*
+	int destination = AUTOPAN_MOD_DEST_PAN;		///< AUTOPAN_MOD_DEST_*
+	double amount = 0.0;						///< -1.0 to +1.0
+};
+
+/**
+\struct AutoPanLFOParameters
+\ingroup FX-Objects
+\brief
+The controls of one of the AutoPan LFOs.
+*/
+struct AutoPanLFOParameters
+{
+	AutoPanLFOParameters() {}
+
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	AutoPanLFOParameters& operator=(const AutoPanLFOParameters& params)
+	{
+		if (this == &params)
+			return *this;
+
+		enable = params.enable;
+		solo = params.solo;
+		waveform = params.waveform;
+		depth = params.depth;
+		rate = params.rate;
+		syncToBPM = params.syncToBPM;
+		phase = params.phase;
+		breakpointShape = params.breakpointShape;
+		trigger = params.trigger;
+
+		// --- MUST be last
+		return *this;
+	}
+
+	bool enable = false;	///< All LFO's start as un-enabled
+	bool solo = false;		///< Solo enable for all LFO's start as un-enabled
+	int waveform = _kSIN;	///< Default Waveform is a Sine wave
+	double depth = 0.00;	///< %
+	double rate = 0.00;		///< Hz
+	int syncToBPM = 0;		///< Defaults to 0 which corresponds with 'off'
+	int phase = kNORMAL_PHASE; ///< Defaults to normal phase
+	bool breakpointShape = false;	///< true = play the breakpoint shape (see AutoPan::setUserWavetable( )) instead of waveform
+	LFOMode trigger = LFOMode::kFreeRun;	///< kFreeRun ignores AutoPan::retriggerLFOs( ), kSync restarts, kOneShot restarts and plays one cycle
+};
+
 /**
 \struct AutoPanParameters
 \ingroup FX-Objects
@@ -31,9 +139,21 @@ Custom parameter structure for the AutoPan object.
 
 enum class channelSelectionEnum { kStereo, kLeft, kRight };
 
+/** how the control rate LFO values are joined up between control points */
+enum class modInterpolationType { kLinear, kCubic };
+
 struct AutoPanParameters
 {
-	AutoPanParameters() {}
+	// --- by default the LFO mix drives the pan, as it always has
+	AutoPanParameters()
+	{
+		modRoute[0].amount = 1.0;
+
+		sidechain.attackTime_mSec = 10.0;
+		sidechain.releaseTime_mSec = 200.0;
+		sidechain.detectMode = TLD_AUDIO_DETECT_MODE_PEAK;
+		sidechain.detect_dB = true;
+	}
 
 	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
 	AutoPanParameters& operator=(const AutoPanParameters& params)	// need this override for collections to work
@@ -45,50 +165,28 @@ struct AutoPanParameters
 			return *this;
 
 		// --- copy from params (argument) INTO our variables
-		enableLFOa = params.enableLFOa;
-		enableLFOb = params.enableLFOb;
-		enableLFOc = params.enableLFOc;
-		enableLFOd = params.enableLFOd;
-
-		soloLFOa = params.soloLFOa;
-		soloLFOb = params.soloLFOb;
-		soloLFOc = params.soloLFOc;
-		soloLFOd = params.soloLFOd;
-
-		LFOaWaveform = params.LFOaWaveform;
-		LFObWaveform = params.LFObWaveform;
-		LFOcWaveform = params.LFOcWaveform;
-		LFOdWaveform = params.LFOdWaveform;
-
-		LFOaDepth = params.LFOaDepth;
-		LFObDepth = params.LFObDepth;
-		LFOcDepth = params.LFOcDepth;
-		LFOdDepth = params.LFOdDepth;
-
-		LFOaRate = params.LFOaRate;
-		LFObRate = params.LFObRate;
-		LFOcRate = params.LFOcRate;
-		LFOdRate = params.LFOdRate;
-
-		LFOaSyncToBPM = params.LFOaSyncToBPM;
-		LFObSyncToBPM = params.LFObSyncToBPM;
-		LFOcSyncToBPM = params.LFOcSyncToBPM;
-		LFOdSyncToBPM = params.LFOdSyncToBPM;
-
-		LFOaPhase = params.LFOaPhase;
-		LFObPhase = params.LFObPhase;
-		LFOcPhase = params.LFOcPhase;
-		LFOdPhase = params.LFOdPhase;
+		for (uint32_t i = 0; i < AUTOPAN_NUM_LFOS; i++)
+			LFO[i] = params.LFO[i];
 
 		volume_dB = params.volume_dB;
 		enableMute = params.enableMute;
 		enableMSdecode = params.enableMSdecode;
 		channelSelection = params.channelSelection;
 		panValue = params.panValue;
+		panLaw = params.panLaw;
 		outputMeterL = params.outputMeterL;
 		outputMeterR = params.outputMeterR;
 		stereoWidth = params.stereoWidth; 
 
+		LFOControlRate = params.LFOControlRate;
+		LFOInterpolation = params.LFOInterpolation;
+		lockLFOsToTransport = params.lockLFOsToTransport;
+
+		for (uint32_t i = 0; i < AUTOPAN_NUM_MOD_ROUTES; i++)
+			modRoute[i] = params.modRoute[i];
+
+		sidechain = params.sidechain;
+
 		bpm = params.bpm;
 
 
@@ -97,51 +195,27 @@ struct AutoPanParameters
 	}
 
 	// --- individual parameters
-	bool enableLFOa = false;	///< All LFO's start as un-enabled
-	bool enableLFOb = false;	///< All LFO's start as un-enabled
-	bool enableLFOc = false;	///< All LFO's start as un-enabled
-	bool enableLFOd = false;	///< All LFO's start as un-enabled
-
-	bool soloLFOa = false;      ///< Solo enable for all LFO's start as un-enabled
-	bool soloLFOb = false;      ///< Solo enable for all LFO's start as un-enabled
-	bool soloLFOc = false;      ///< Solo enable for all LFO's start as un-enabled
-	bool soloLFOd = false;      ///< Solo enable for all LFO's start as un-enabled
-
-	int LFOaWaveform = _kSIN; ///< Default Waveform for LFO 'A' is a Sine wave
-	int LFObWaveform = _kSIN; ///< Default Waveform for LFO 'B' is a Sine wave
-	int LFOcWaveform = _kSIN; ///< Default Waveform for LFO 'C' is a Sine wave
-	int LFOdWaveform = _kSIN; ///< Default Waveform for LFO 'D' is a Sine wave
-
-	double LFOaDepth = 0.00;
-	double LFObDepth = 0.00;
-	double LFOcDepth = 0.00;
-	double LFOdDepth = 0.00;
-
-	double LFOaRate = 0.00;
-	double LFObRate = 0.00;
-	double LFOcRate = 0.00;
-	double LFOdRate = 0.00;
-
-	int LFOaSyncToBPM = 0; ///< Defaults to 0 which corresponds with 'off'
-	int LFObSyncToBPM = 0; ///< Defaults to 0 which corresponds with 'off'
-	int LFOcSyncToBPM = 0; ///< Defaults to 0 which corresponds with 'off'
-	int LFOdSyncToBPM = 0; ///< Defaults to 0 which corresponds with 'off'
-
-	int LFOaPhase = kNORMAL_PHASE; ///< Defaults to normal phase
-	int LFObPhase = kNORMAL_PHASE; ///< Defaults to normal phase
-	int LFOcPhase = kNORMAL_PHASE; ///< Defaults to normal phase
-	int LFOdPhase = kNORMAL_PHASE; ///< Defaults to normal phase
+	AutoPanLFOParameters LFO[AUTOPAN_NUM_LFOS];	///< LFO 'A', 'B', 'C', 'D'
 
 	double volume_dB = 0.00;
 	bool enableMute = false;
 	bool enableMSdecode = false;
 	channelSelectionEnum channelSelection = channelSelectionEnum::kStereo;
 	double panValue = 0.00;
+	panLawType panLaw = panLawType::k3dB;	///< used for both the static pan and the LFO pan
 	float outputMeterL = 0.f;
 	float outputMeterR = 0.f;
 	double stereoWidth = 0.00;  ///< Defaults to 0% width (range -100% to 100%)
 
+	uint32_t LFOControlRate = 16;	///< LFOs are rendered every this many samples; 1 = full rate
+	modInterpolationType LFOInterpolation = modInterpolationType::kLinear;	///< interpolation between control rate LFO values
+	bool lockLFOsToTransport = false;	///< true = LFO phases follow the host position, see AutoPan::syncToTransport( )
+
+	AutoPanModRoute modRoute[AUTOPAN_NUM_MOD_ROUTES];	///< modulation matrix routes; route 0 is LFO mix -> pan by default
+	AudioDetectorParameters sidechain;	///< sidechain envelope detector; detect_dB is expected (see kAutoPanSidechainRange_dB)
+
 	double bpm = 0.00;
+	uint32_t bpmRampSamples = 0;	///< reach a new bpm with a linear ramp this long, for hosts that report tempo ramps; 0 = jump
 };
 
 
@@ -152,21 +226,34 @@ struct AutoPanParameters
 The AutoPan object implements ....
 
 Audio I/O:
-- Processes mono input to mono output.
-- *** Optionally, process frame *** Modify this according to your object functionality
+- Processes mono or stereo input to mono or stereo output.
+- Surround outputs (LCR up to 7.1, see setChannelFormats( )) rotate the whole input sound field
+  round the speaker ring instead: the pan turns it, +/-1.0 = half a turn, with VBAP gains worked
+  out at control rate and ramped across each control period. Width, M/S decode, channel select
+  and the pan law are stereo only; volume, mute and the LFE pass straight through.
 
 Control I/F:
 - Use AutoPanParameters structure to get/set object params.
 
+Sample type:
+- T is the type the DSP runs in: AutoPan<float> matches the host buffers and doubles the SIMD width
+  of the LFO bank and pan law; AutoPan<double> (the default) is kept for reference. The LFO phase
+  accumulators are double in both.
+
 \author <Aaron Mutchler> <http://www.aaronmutchler.com>
 \remark <Put any remarks or notes here>
 \version Revision : 1.0
 \date Date : 2019 / 01 / 31
 */
+template <typename T = double>
 class AutoPan : public IAudioSignalProcessor
 {
 public:
-	AutoPan(void) {}	/* C-TOR */
+	AutoPan(void)	/* C-TOR */
+	{
+		sidechainDetector.setParameters(parameters.sidechain);
+		cookModMatrix();
+	}
 	~AutoPan(void) {}	/* D-TOR */
 
 public:
@@ -179,10 +266,23 @@ public:
 		// --- do any other per-audio-run inits here
 		AutoPanParameters params = getParameters();
 
-		LFOa.reset(sampleRate);
-		LFOb.reset(sampleRate);
-		LFOc.reset(sampleRate);
-		LFOd.reset(sampleRate);
+		// --- the LFOs run at the control rate
+		double controlSampleRate = sampleRate / getLFOControlRate();
+		LFOs.reset(controlSampleRate);
+		tempoSync.setSampleRate(controlSampleRate);
+
+		// --- the sidechain detector runs once per LFO render
+		sidechainDetector.reset(controlSampleRate);
+		finishSidechainPeriod();
+		sidechainLevel = 0.0;
+
+		modHistoryPrimed = false;
+		modControlCounter = 0;
+		transportLocked = false;
+
+		// --- a new run starts on the target matrix, not a ramp to it
+		stereoMatrixSnap = true;
+		surroundMatrixSnap = true;
 
 		return true;
 	}
@@ -224,238 +324,1085 @@ public:
 					     uint32_t inputChannels,
 					     uint32_t outputChannels)
 	{
-		AutoPanParameters params = getParameters();
-		SuperLFOParameters LFOparams;
+		// Split input frame into left and right signal; see setSidechainFrame( ) for the sidechain
+		const float* xnL = &inputFrame[0];
+		const float* xnR = inputChannels == 1 ? &inputFrame[0] : &inputFrame[1];
+
+		T panMod = (T)0.0;
+		bool periodStart = startsControlPeriod();
+		if (sidechainActive && periodStart)
+			finishSidechainPeriod();
+		renderPanModulation(&panMod, 1);
+		transportSample++;
+
+		if (sidechainActive && sidechainFrame)
+			accumulateSidechainFrame(sidechainFrame, sidechainFrameChannels);
+
+		// --- surround: the block DSP with one-frame channel pointers
+		if (surroundActive)
+		{
+			const float* inputs[VBAP_MAX_SPEAKERS];
+			float* outputs[VBAP_MAX_SPEAKERS];
+			uint32_t numInputs = inputChannels < VBAP_MAX_SPEAKERS ? inputChannels : VBAP_MAX_SPEAKERS;
+			uint32_t numOutputs = outputChannels < VBAP_MAX_SPEAKERS ? outputChannels : VBAP_MAX_SPEAKERS;
+			for (uint32_t ch = 0; ch < numInputs; ch++)
+				inputs[ch] = &inputFrame[ch];
+			for (uint32_t ch = 0; ch < numOutputs; ch++)
+				outputs[ch] = &outputFrame[ch];
+			for (uint32_t ch = numOutputs; ch < outputChannels; ch++)
+				outputFrame[ch] = 0.f;
+
+			if (periodStart || surroundMatrixSnap)
+				cookSurroundMatrix(panMod);
+			processSurroundMatrix(inputs, outputs, 0, 1, numInputs, numOutputs);
+
+			parameters.outputMeterL = outputFrame[0];
+			parameters.outputMeterR = outputChannels > 1 ? outputFrame[1] : outputFrame[0];
+			return true;
+		}
+
+		T modGainL = (T)0.0;
+		T modGainR = (T)0.0;
+		calculatePanGains(parameters.panLaw, panMod, modGainL, modGainR);
+
+		float ynL = 0.f;
+		float ynR = 0.f;
+		processStereoMatrix(xnL, xnR, &modGainL, &modGainR, &ynL, &ynR, 1);
+
+		outputFrame[0] = ynL;
+		if (outputChannels == 2) {
+			outputFrame[1] = ynR;
+		}
+
+		parameters.outputMeterL = ynL;
+		parameters.outputMeterR = ynR;
+
+		return true;
+	}
 
-		double activeLFOcount = 0.0;
+	/** process a block of audio: same DSP as processAudioFrame( ) but operates on whole, non-interleaved host buffers */
+	/**
+	\param inputs array of input channel buffers: inputs[0] = left, inputs[1] = right, etc...
+	\param outputs array of output channel buffers
+	\param numFrames number of frames (samples per channel) in the buffers
+	\param inputChannels number of input channels
+	\param outputChannels number of output channels
+	\param sidechain array of sidechain (aux input) channel buffers, or nullptr
+	\param sidechainChannels number of sidechain channels
+	\return true if processed
+	*/
+	virtual bool processAudioBlock(const float* const* inputs,
+						   float** outputs,
+						   uint32_t numFrames,
+						   uint32_t inputChannels,
+						   uint32_t outputChannels,
+						   const float* const* sidechain = nullptr,
+						   uint32_t sidechainChannels = 0)
+	{
+		if (numFrames == 0)
+			return true;
+
+		const float* inL = inputs[0];
+		const float* inR = inputChannels == 1 ? inputs[0] : inputs[1];
+		float* outL = outputs[0];
+
+		// --- render the combined LFO in chunks so the pan law runs over whole modulation buffers
+		T panMod[AUTOPAN_MOD_CHUNK];
+		T modGainL[AUTOPAN_MOD_CHUNK];
+		T modGainR[AUTOPAN_MOD_CHUNK];
+
+		// --- a mono output still needs somewhere for the right channel to go
+		float discardR[AUTOPAN_MOD_CHUNK];
+
+		uint32_t chunk = 0;
+		for (uint32_t start = 0; start < numFrames; start += chunk)
+		{
+			chunk = numFrames - start < AUTOPAN_MOD_CHUNK ? numFrames - start : AUTOPAN_MOD_CHUNK;
+
+			// --- modulated width or volume re-cooks the stereo matrix on every LFO render, the surround
+			//     matrix is cooked at every control point, and each render reads the sidechain level of
+			//     the control period before it; stop the chunk at the next control point so each matrix
+			//     ramp is run, and each period measured, on its own
+			if (modDrivesStereo || sidechainActive || surroundActive)
+			{
+				uint32_t controlRate = getLFOControlRate();
+				uint32_t toNextPoint = controlRate - modControlCounter % controlRate;
+				if (chunk > toNextPoint) chunk = toNextPoint;
+			}
 
-		double LFOaModifier = 0.0;
-		double LFObModifier = 0.0;
-		double LFOcModifier = 0.0;
-		double LFOdModifier = 0.0;
+			bool periodStart = startsControlPeriod();
+			if (sidechainActive && periodStart)
+				finishSidechainPeriod();
 
-		double syncedNoteValues[6];
-		//double noteValues[6] = { 3.0, 2.0, 1.5, 1.0, 0.5, 0.25 }; ///< Corresponds to eighth note triplets, eighth note, quarter note triplet, quarter note, half note, whole note
+			renderPanModulation(panMod, chunk);
 
-		double noteValues[6] = { 0.125, 0.334, 0.5, 1.0, 2.0, 4.0 }; ///< Corresponds to eighth note triplets, eighth note, quarter note triplet, quarter note, half note, whole note
+			if (sidechainActive)
+				accumulateSidechain(sidechain, sidechainChannels, start, chunk);
 
-		// Split input frame into left and right signal
-		double xnL = inputFrame[0];
-		double xnR = inputChannels == 1 ? inputFrame[0] : inputFrame[1];
+			if (surroundActive)
+			{
+				if (periodStart || surroundMatrixSnap)
+					cookSurroundMatrix(panMod[0]);
+				processSurroundMatrix(inputs, outputs, start, chunk, inputChannels, outputChannels);
+				continue;
+			}
+
+			calculatePanGains(parameters.panLaw, panMod, modGainL, modGainR, chunk);
 
-		if (params.enableMSdecode) {
-			double side = 0.5 * (xnL - xnR);
-			double mid = 0.5 * (xnL + xnR);
-			xnL = mid + side;
-			xnR = mid - side;
+			float* outR = outputChannels >= 2 ? outputs[1] + start : discardR;
+			processStereoMatrix(inL + start, inR + start, modGainL, modGainR, outL + start, outR, chunk);
+
+			// --- meters get the last sample of the block
+			if (start + chunk == numFrames)
+			{
+				parameters.outputMeterL = outL[numFrames - 1];
+				parameters.outputMeterR = outR[chunk - 1];
+			}
 		}
-		
-		// Sync beats to tempo
 
-		double bps = params.bpm / 60.0;
-		for (int i = 0; i < 6; i++) {
-			syncedNoteValues[i] = (bps * noteValues[i]);
+		if (surroundActive)
+		{
+			parameters.outputMeterL = outputs[0][numFrames - 1];
+			parameters.outputMeterR = outputChannels > 1 ? outputs[1][numFrames - 1] : outputs[0][numFrames - 1];
 		}
+		else
+		{
+			// --- stereo only produces L/R; silence any other output channels
+			for (uint32_t ch = 2; ch < outputChannels; ch++)
+				memset(outputs[ch], 0, sizeof(float)*numFrames);
+		}
+
+		transportSample += numFrames;
+		return true;
+	}
+
+	/** silent input gives silent output whatever the settings: write zeros and only move the LFOs along */
+	/**
+	\param outputs array of output channel buffers
+	\param numFrames number of frames (samples per channel) in the buffers
+	\param outputChannels number of output channels
+	\param sidechain array of sidechain (aux input) channel buffers, or nullptr; the envelope keeps following it
+	\param sidechainChannels number of sidechain channels
+	\return true if processed
+	*/
+	virtual bool processSilentBlock(float** outputs,
+							uint32_t numFrames,
+							uint32_t outputChannels,
+							const float* const* sidechain = nullptr,
+							uint32_t sidechainChannels = 0)
+	{
+		for (uint32_t ch = 0; ch < outputChannels; ch++)
+			memset(outputs[ch], 0, sizeof(float)*numFrames);
+
+		// --- the skipped renders all read the level of this block
+		if (sidechainActive)
+		{
+			accumulateSidechain(sidechain, sidechainChannels, 0, numFrames);
+			finishSidechainPeriod();
+		}
+
+		advancePanModulation(numFrames);
+		transportSample += numFrames;
+
+		parameters.outputMeterL = 0.f;
+		parameters.outputMeterR = 0.f;
+
+		return true;
+	}
+
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return AutoPanParameters custom data structure
+	*/
+	AutoPanParameters getParameters()
+	{
+		return parameters;
+	}
+
+	/** get the most recent left output value for metering */
+	float getOutputMeterL() { return parameters.outputMeterL; }
 
-		// Calculate LFOs A through D outputs
+	/** get the most recent right output value for metering */
+	float getOutputMeterR() { return parameters.outputMeterR; }
 
-		if (params.enableLFOa) {
-			LFOparams.frequency_Hz = params.LFOaRate;
-			if (params.LFOaSyncToBPM != 0) {
-				LFOparams.frequency_Hz = (1.0 / syncedNoteValues[params.LFOaSyncToBPM - 1]);
-				boundValue(LFOparams.frequency_Hz, 0.02, 20);
+	/** tell the object the host's channel formats; a surround output with a known speaker layout
+	    (see getSpeakerLayout( )) switches on the surround rotation, anything else is stereo. Cheap
+	    when nothing changed, so call at the top of every buffer */
+	/**
+	\param inputFormat channelFormat of the main input
+	\param outputFormat channelFormat of the main output
+	*/
+	void setChannelFormats(uint32_t inputFormat, uint32_t outputFormat)
+	{
+		if (inputFormat == surroundInputFormat && outputFormat == surroundOutputFormat)
+			return;
+
+		surroundInputFormat = inputFormat;
+		surroundOutputFormat = outputFormat;
+		surroundActive = getSpeakerLayout(outputFormat, surroundOutputs) && surroundOutputs.numChannels > 2 &&
+						 outputPanner.setLayout(surroundOutputs) && getSpeakerLayout(inputFormat, surroundInputs);
+		numSurroundTaps = 0;
+		surroundMatrixSnap = true;
+	}
+
+	/** true if the outputs are a surround layout; every output channel may then carry audio */
+	bool isSurroundActive() { return surroundActive; }
+
+	/** with lockLFOsToTransport set, place the LFO phases from the host position; call at the top of every
+		buffer, after setParameters( ). Each periodic lane's phase is computed directly for its next render:
+		tempo synced lanes from the musical position, free running lanes from the absolute sample index.
+		Inside the buffer the phases accumulate as usual, so nothing drifts from buffer to buffer, and a
+		given position always renders the same, however the song is split up. The control points sit
+		on a grid counted from sample 0; after a transport jump (or when the lock is switched on) the
+		interpolation history is rebuilt on that grid. The random waveforms are not position locked.
+	*/
+	/**
+	\param absoluteSample sample index of the first frame of the buffer
+	\param quarterNotes musical position of the first frame of the buffer, in quarter notes
+	*/
+	void syncToTransport(uint64_t absoluteSample, double quarterNotes)
+	{
+		if (!parameters.lockLFOsToTransport || sampleRate <= 0.0)
+		{
+			transportLocked = false;
+			return;
+		}
+
+		uint32_t controlRate = getLFOControlRate();
+		bool jumped = !transportLocked || absoluteSample != transportSample;
+		transportLocked = true;
+		transportSample = absoluteSample;
+
+		// --- full rate: the next render is this sample
+		if (controlRate == 1)
+		{
+			setTransportPhases(absoluteSample, (int64_t)absoluteSample, quarterNotes);
+			return;
+		}
+
+		// --- control point k starts at sample k*controlRate
+		uint32_t counter = (uint32_t)(absoluteSample % controlRate);
+		int64_t pointStart = (int64_t)(absoluteSample - counter);
+
+		if (jumped || !modHistoryPrimed)
+		{
+			// --- render the history k-1 .. k+2 from the transport phases
+			setTransportPhases(absoluteSample, pointStart - (int64_t)controlRate, quarterNotes);
+			for (uint32_t i = 0; i < 4; i++)
+				modHistory[i] = renderLFOs();
+			modControlCounter = counter;
+			modHistoryPrimed = true;
+			return;
+		}
+
+		// --- carrying on: the history holds up to point k+2 of the current period, so the bank's
+		//     next render is point k+3; put it exactly where the transport says
+		setTransportPhases(absoluteSample, (int64_t)absoluteSample - modControlCounter + 3 * (int64_t)controlRate, quarterNotes);
+	}
+
+	/** restart the LFOs whose trigger is LFOMode::kSync or kOneShot, e.g. on a MIDI note-on; call between
+	    blocks, with the block split at the note so the restart lands on its sample. At control rate the
+	    interpolation history is rebuilt from this sample: the restarted LFOs start from phase 0.0 here and
+	    the free running ones are pulled back from the render ahead so they carry on unbroken
+	*/
+	void retriggerLFOs()
+	{
+		bool anyRetriggered = false;
+		for (uint32_t lane = 0; lane < AUTOPAN_NUM_LFOS; lane++)
+			anyRetriggered |= parameters.LFO[lane].trigger != LFOMode::kFreeRun;
+		if (!anyRetriggered)
+			return;
+
+		uint32_t controlRate = getLFOControlRate();
+		if (controlRate > 1 && modHistoryPrimed)
+		{
+			// --- the bank's next render is point k+3, (3*controlRate - modControlCounter) samples from here
+			double ticksAhead = 3.0 - (double)modControlCounter / controlRate;
+			for (uint32_t lane = 0; lane < AUTOPAN_NUM_LFOS; lane++)
+			{
+				if (parameters.LFO[lane].trigger == LFOMode::kFreeRun)
+					LFOs.setLanePhase(lane, LFOs.getLanePhase(lane) - LFOs.getLanePhaseIncrement(lane)*ticksAhead);
 			}
-			LFOparams.outputAmplitude = params.LFOaDepth / 100.0;
+			modHistoryPrimed = false;
+			modControlCounter = 0;
+		}
 
-			if (params.LFOaWaveform == _kSIN) { LFOparams.waveform = LFOWaveform::kSin; }
-			else if (params.LFOaWaveform == _kTRIANGLE) { LFOparams.waveform = LFOWaveform::kTriangle; }
-			else if (params.LFOaWaveform == _kSAW) { LFOparams.waveform = LFOWaveform::kSaw; }
-			else if (params.LFOaWaveform == _kQRSH) { LFOparams.waveform = LFOWaveform::kQRSH; }
+		LFOs.retriggerLanes();
+	}
 
-			LFOa.setParameters(LFOparams);
-			SignalModulatorOutput output = LFOa.renderModulatorOutput();
+	/** give processAudioFrame( ) the sidechain frame that goes with its next input frame */
+	/**
+	\param _sidechainFrame one frame of the aux input, one sample per channel, valid until processAudioFrame( )
+	       returns; nullptr = no sidechain
+	\param sidechainChannels number of sidechain channels
+	*/
+	void setSidechainFrame(const float* _sidechainFrame, uint32_t sidechainChannels)
+	{
+		sidechainFrame = _sidechainFrame;
+		sidechainFrameChannels = sidechainChannels;
+	}
+
+	/** set the table played by the breakpoint waveform; call from the audio thread (e.g. with the table from
+	    an LFOWavetableExchange) and keep the table alive and unchanged until the next call */
+	void setUserWavetable(const LFOWavetable* table) { LFOs.setUserWavetable(table); }
 
-			if (params.LFOaPhase == kQUAD_INVERTED_PHASE) { LFOaModifier = output.quadPhaseOutput_neg; }
-			else if (params.LFOaPhase == kNORMAL_PHASE) { LFOaModifier = output.normalOutput; }
-			else if (params.LFOaPhase == kQUAD_PHASE) { LFOaModifier = output.quadPhaseOutput_pos; }
-			else if (params.LFOaPhase == kINVERTED_PHASE) { LFOaModifier = output.invertedOutput; }
-			activeLFOcount++;
+	/** give the random LFO waveforms a fixed seed, applied at the next reset( ), so renders are reproducible */
+	void setRandomSeed(uint64_t seed) { LFOs.setRandomSeed(seed); }
+
+	/** set parameters: note use of custom structure for passing param data; cooks everything */
+	/**
+	\param AutoPanParameters custom data structure
+	*/
+	void setParameters(const AutoPanParameters& params)
+	{
+		setParameters(params, AUTOPAN_CHANGED_ALL);
+	}
+
+	/** set parameters and re-cook only the groups flagged in changes; call at most once per buffer */
+	/**
+	\param params custom data structure holding the latest value of every control
+	\param changes OR'd AUTOPAN_CHANGED_* flags naming the groups that differ from the last call
+	*/
+	void setParameters(const AutoPanParameters& params, uint32_t changes)
+	{
+		if (changes == 0)
+			return;
+
+		uint32_t oldControlRate = getLFOControlRate();
+
+		// --- the meters are ours, not the caller's
+		float meterL = parameters.outputMeterL;
+		float meterR = parameters.outputMeterR;
+		parameters = params;
+		parameters.outputMeterL = meterL;
+		parameters.outputMeterR = meterR;
+
+		if (changes & AUTOPAN_CHANGED_VOLUME)
+		{
+			// --- if dB = -60, then we shut off completely
+			if (parameters.volume_dB == -60.0) {
+				volumeCooked = (T)0.0;
+			}
+			else {
+				volumeCooked = (T)pow(10.0, parameters.volume_dB / 20.0);
+			}
+		}
+
+		// --- static pan; same pan law engine as the LFO modulation
+		if (changes & AUTOPAN_CHANGED_PAN)
+			calculatePanGains(parameters.panLaw, (T)parameters.panValue, panValue_L, panValue_R);
+
+		if (changes & (AUTOPAN_CHANGED_VOLUME | AUTOPAN_CHANGED_PAN | AUTOPAN_CHANGED_ROUTING))
+			cookStereoMatrix();
+
+		if (changes & (AUTOPAN_CHANGED_LFOS | AUTOPAN_CHANGED_TEMPO))
+			cookLFOs(changes);
+
+		if (changes & AUTOPAN_CHANGED_MOD_MATRIX)
+			cookModMatrix();
+
+		if (changes & AUTOPAN_CHANGED_SIDECHAIN)
+			sidechainDetector.setParameters(parameters.sidechain);
+
+		// --- the next syncToTransport( ) starts over
+		if (changes & AUTOPAN_CHANGED_TRANSPORT_LOCK)
+			transportLocked = false;
+
+		// --- new control rate: re-clock the LFOs (phase is kept) and restart the interpolator
+		if ((changes & AUTOPAN_CHANGED_CONTROL_RATE) && getLFOControlRate() != oldControlRate)
+		{
+			if (sampleRate > 0.0)
+			{
+				LFOs.setSampleRate(sampleRate / getLFOControlRate());
+				tempoSync.setSampleRate(sampleRate / getLFOControlRate());
+				sidechainDetector.setSampleRate(sampleRate / getLFOControlRate());
+			}
+			modHistoryPrimed = false;
+			modControlCounter = 0;
+		}
+	}
+
+private:
+	/** transfer our LFO controls into the LFO bank lanes whose controls changed; a tempo change only
+	    touches the synced lanes, whose increments come straight from the tempo sync cache */
+	void cookLFOs(uint32_t changes)
+	{
+		bool tempoChanged = false;
+		if (changes & AUTOPAN_CHANGED_TEMPO)
+		{
+			uint32_t controlRate = getLFOControlRate();
+			uint32_t rampTicks = (parameters.bpmRampSamples + controlRate - 1) / controlRate;
+			tempoChanged = tempoSync.rampToTempo(parameters.bpm, rampTicks) && !tempoSync.isRamping();
 		}
 
-		if (params.enableLFOb) {
-			LFOparams.frequency_Hz = params.LFObRate;
-			if (params.LFObSyncToBPM != 0) {
-				LFOparams.frequency_Hz = syncedNoteValues[params.LFObSyncToBPM - 1];
+		for (uint32_t lane = 0; lane < AUTOPAN_NUM_LFOS; lane++)
+		{
+			const AutoPanLFOParameters& lfo = parameters.LFO[lane];
+			if ((changes & (1 << lane)) == 0)
+			{
+				if (tempoChanged && tempoSync.isSynced(lane))
+					LFOs.setLanePhaseIncrement(lane, tempoSync.getPhaseIncrement(lane));
+				continue;
 			}
-			LFOparams.outputAmplitude = params.LFObDepth / 100.0;
 
-			if (params.LFObWaveform == _kSIN) { LFOparams.waveform = LFOWaveform::kSin; }
-			else if (params.LFObWaveform == _kTRIANGLE) { LFOparams.waveform = LFOWaveform::kTriangle; }
-			else if (params.LFObWaveform == _kSAW) { LFOparams.waveform = LFOWaveform::kSaw; }
-			else if (params.LFObWaveform == _kQRSH) { LFOparams.waveform = LFOWaveform::kQRSH; }
+			tempoSync.setDivision(lane, lfo.syncToBPM);
+
+			SuperLFOParameters lfoParams = LFOs.getLaneParameters(lane);
+			lfoParams.frequency_Hz = tempoSync.isSynced(lane) ? tempoSync.getFrequency(lane) : lfo.rate;
+			lfoParams.outputAmplitude = lfo.depth / 100.0;
+			lfoParams.waveform = lfo.breakpointShape ? LFOWaveform::kUser : convertLFOWaveform(lfo.waveform, lfoParams.waveform);
+			lfoParams.mode = lfo.trigger;
+
+			LFOs.setLaneParameters(lane, lfoParams, convertLFOPhase(lfo.phase));
+			LFOs.setLaneEnable(lane, lfo.enable, lfo.solo);
+		}
+	}
+
+	/** render the LFO bank once; a running tempo ramp moves one step first */
+	inline T renderLFOs()
+	{
+		if (tempoSync.isRamping())
+		{
+			tempoSync.advanceRamp(1);
+			for (uint32_t lane = 0; lane < AUTOPAN_NUM_LFOS; lane++)
+				if (tempoSync.isSynced(lane))
+					LFOs.setLanePhaseIncrement(lane, tempoSync.getPhaseIncrement(lane));
+		}
+		return applyModMatrix(LFOs.renderCombinedOutput());
+	}
 
-			LFOb.setParameters(LFOparams);
-			SignalModulatorOutput output = LFOb.renderModulatorOutput();
+	/** rebuild the modulation matrix from the route parameters; destinations that lose their last route
+	    go back to unmodulated */
+	void cookModMatrix()
+	{
+		modMatrix.clearRoutes();
+		for (uint32_t i = 0; i < AUTOPAN_NUM_MOD_ROUTES; i++)
+		{
+			const AutoPanModRoute& route = parameters.modRoute[i];
+			if (route.source >= 0 && route.destination >= 0)
+				modMatrix.addRoute((uint32_t)route.source, (uint32_t)route.destination, route.amount);
+		}
 
-			if (params.LFObPhase == kQUAD_INVERTED_PHASE) { LFObModifier = output.quadPhaseOutput_neg; }
-			else if (params.LFObPhase == kNORMAL_PHASE) { LFObModifier = output.normalOutput; }
-			else if (params.LFObPhase == kQUAD_PHASE) { LFObModifier = output.quadPhaseOutput_pos; }
-			else if (params.LFObPhase == kINVERTED_PHASE) { LFObModifier = output.invertedOutput; }
-			activeLFOcount++;
+		bool drivesStereo = modMatrix.isDestinationActive(AUTOPAN_MOD_DEST_WIDTH) || modMatrix.isDestinationActive(AUTOPAN_MOD_DEST_VOLUME);
+		if (modDrivesStereo && !drivesStereo)
+		{
+			widthMod = (T)0.0;
+			volumeModGain = (T)1.0;
+			cookStereoMatrix();
+		}
+		modDrivesStereo = drivesStereo;
+
+		// --- the sidechain is only detected while a route reads it
+		sidechainActive = modMatrix.isSourceActive(AUTOPAN_MOD_SOURCE_SIDECHAIN);
+		if (!sidechainActive)
+		{
+			finishSidechainPeriod();
+			sidechainLevel = 0.0;
 		}
 
-		if (params.enableLFOc) {
-			LFOparams.frequency_Hz = params.LFOcRate;
-			if (params.LFOcSyncToBPM != 0) {
-				LFOparams.frequency_Hz = syncedNoteValues[params.LFOcSyncToBPM - 1];
+		modDrivesLFOs = false;
+		for (uint32_t lane = 0; lane < AUTOPAN_NUM_LFOS; lane++)
+		{
+			laneModulated[lane] = modMatrix.isDestinationActive(AUTOPAN_MOD_DEST_LFO_RATE + lane) ||
+								  modMatrix.isDestinationActive(AUTOPAN_MOD_DEST_LFO_DEPTH + lane);
+			if (laneModulated[lane])
+				modDrivesLFOs = true;
+			else
+				LFOs.setLaneModulation(lane, 1.0, (T)1.0);
+		}
+	}
+
+	/** run the modulation matrix on the LFO outputs of the render just done and apply it; LFO rate and
+	    depth take effect from the next render, width and volume ramp in over one control period
+	    (ahead of the pan by the interpolator's look ahead)
+	*/
+	/**
+	\param lfoMix the average of the audible LFOs
+	\return the pan modulation
+	*/
+	inline T applyModMatrix(T lfoMix)
+	{
+		T sources[AUTOPAN_NUM_MOD_SOURCES];
+		sources[AUTOPAN_MOD_SOURCE_LFO_MIX] = lfoMix;
+		const T* laneOutputs = LFOs.getLaneOutputs();
+		for (uint32_t lane = 0; lane < AUTOPAN_NUM_LFOS; lane++)
+			sources[AUTOPAN_MOD_SOURCE_LFO + lane] = laneOutputs[lane];
+		sources[AUTOPAN_MOD_SOURCE_SIDECHAIN] = sidechainActive ? renderSidechainEnvelope() : (T)0.0;
+
+		T destinations[AUTOPAN_NUM_MOD_DESTINATIONS];
+		modMatrix.evaluate(sources, destinations);
+
+		if (modDrivesLFOs)
+		{
+			for (uint32_t lane = 0; lane < AUTOPAN_NUM_LFOS; lane++)
+			{
+				if (!laneModulated[lane])
+					continue;
+
+				double rateScale = pow(2.0, kAutoPanModRateRange*destinations[AUTOPAN_MOD_DEST_LFO_RATE + lane]);
+				T depthScale = (T)1.0 + destinations[AUTOPAN_MOD_DEST_LFO_DEPTH + lane];
+				LFOs.setLaneModulation(lane, rateScale, depthScale > (T)0.0 ? depthScale : (T)0.0);
 			}
-			LFOparams.outputAmplitude = params.LFOcDepth / 100.0;
+		}
 
-			if (params.LFOcWaveform == _kSIN) { LFOparams.waveform = LFOWaveform::kSin; }
-			else if (params.LFOcWaveform == _kTRIANGLE) { LFOparams.waveform = LFOWaveform::kTriangle; }
-			else if (params.LFOcWaveform == _kSAW) { LFOparams.waveform = LFOWaveform::kSaw; }
-			else if (params.LFOcWaveform == _kQRSH) { LFOparams.waveform = LFOWaveform::kQRSH; }
+		if (modDrivesStereo)
+		{
+			widthMod = destinations[AUTOPAN_MOD_DEST_WIDTH];
+			volumeModGain = (T)pow(10.0, kAutoPanModVolumeRange_dB*destinations[AUTOPAN_MOD_DEST_VOLUME] / 20.0);
+			cookStereoMatrix();
+		}
 
-			LFOc.setParameters(LFOparams);
-			SignalModulatorOutput output = LFOc.renderModulatorOutput();
+		return destinations[AUTOPAN_MOD_DEST_PAN];
+	}
 
-			if (params.LFOcPhase == kQUAD_INVERTED_PHASE) { LFOcModifier = output.quadPhaseOutput_neg; }
-			else if (params.LFOcPhase == kNORMAL_PHASE) { LFOcModifier = output.normalOutput; }
-			else if (params.LFOcPhase == kQUAD_PHASE) { LFOcModifier = output.quadPhaseOutput_pos; }
-			else if (params.LFOcPhase == kINVERTED_PHASE) { LFOcModifier = output.invertedOutput; }
-			activeLFOcount++;
+	/** skip the LFO bank numTicks renders ahead; O(1) unless a tempo ramp is running, which is stepped
+	    render by render so the phases land where rendering would have put them */
+	void advanceLFOs(uint64_t numTicks)
+	{
+		// --- the sidechain envelope keeps time with the skipped renders; they all read the same
+		//     level, so the detector jumps in one step
+		if (sidechainActive)
+			sidechainDetector.processConstantInput(sidechainLevel, numTicks);
+
+		while (numTicks > 0 && tempoSync.isRamping())
+		{
+			tempoSync.advanceRamp(1);
+			for (uint32_t lane = 0; lane < AUTOPAN_NUM_LFOS; lane++)
+				if (tempoSync.isSynced(lane))
+					LFOs.setLanePhaseIncrement(lane, tempoSync.getPhaseIncrement(lane));
+			LFOs.advance(1);
+			numTicks--;
 		}
+		LFOs.advance(numTicks);
+	}
+
+	/** run the sidechain detector for one LFO render; its level in dB, mapped to 0.0 .. 1.0 */
+	inline T renderSidechainEnvelope()
+	{
+		double envelope_dB = sidechainDetector.processAudioSample(sidechainLevel);
+		double envelope = (envelope_dB + kAutoPanSidechainRange_dB) / kAutoPanSidechainRange_dB;
+		boundValue(envelope, 0.0, 1.0);
+		return (T)envelope;
+	}
+
+	/** true if the next sample starts a control period, so renderPanModulation( ) renders the LFOs on it */
+	bool startsControlPeriod()
+	{
+		uint32_t controlRate = getLFOControlRate();
+		return controlRate == 1 || !modHistoryPrimed || modControlCounter >= controlRate;
+	}
 
-		if (params.enableLFOd) {
-			LFOparams.frequency_Hz = params.LFOdRate;
-			if (params.LFOdSyncToBPM != 0) {
-				LFOparams.frequency_Hz = syncedNoteValues[params.LFOdSyncToBPM - 1];
+	/** add a stretch of the sidechain to the current period's peak and sum of squares, over every
+	    channel; four independent accumulators keep the loop branch free so it vectorizes without
+	    fast-math */
+	/**
+	\param sidechain array of sidechain channel buffers, or nullptr
+	\param numChannels number of sidechain channels
+	\param startFrame first frame of the stretch
+	\param numFrames length of the stretch
+	*/
+	void accumulateSidechain(const float* const* sidechain, uint32_t numChannels, uint32_t startFrame, uint32_t numFrames)
+	{
+		if (!sidechain || numChannels == 0 || numFrames == 0)
+			return;
+
+		float peak[4] = { 0.f, 0.f, 0.f, 0.f };
+		float sumSquares[4] = { 0.f, 0.f, 0.f, 0.f };
+		for (uint32_t ch = 0; ch < numChannels; ch++)
+		{
+			const float* x = sidechain[ch] + startFrame;
+			uint32_t i = 0;
+			for (; i + 4 <= numFrames; i += 4)
+			{
+				for (uint32_t k = 0; k < 4; k++)
+				{
+					float a = fabsf(x[i + k]);
+					peak[k] = a > peak[k] ? a : peak[k];
+					sumSquares[k] += a*a;
+				}
+			}
+			for (; i < numFrames; i++)
+			{
+				float a = fabsf(x[i]);
+				peak[0] = a > peak[0] ? a : peak[0];
+				sumSquares[0] += a*a;
 			}
-			LFOparams.outputAmplitude = params.LFOdDepth / 100.0;
+		}
 
-			if (params.LFOdWaveform == _kSIN) { LFOparams.waveform = LFOWaveform::kSin; }
-			else if (params.LFOdWaveform == _kTRIANGLE) { LFOparams.waveform = LFOWaveform::kTriangle; }
-			else if (params.LFOdWaveform == _kSAW) { LFOparams.waveform = LFOWaveform::kSaw; }
-			else if (params.LFOdWaveform == _kQRSH) { LFOparams.waveform = LFOWaveform::kQRSH; }
+		sidechainPeak = fmax(sidechainPeak, fmax(fmax(peak[0], peak[1]), fmax(peak[2], peak[3])));
+		sidechainSumSquares += (double)sumSquares[0] + sumSquares[1] + sumSquares[2] + sumSquares[3];
+		sidechainCount += numFrames*numChannels;
+	}
 
-			LFOd.setParameters(LFOparams);
-			SignalModulatorOutput output = LFOd.renderModulatorOutput();
+	/** add one interleaved sidechain frame to the current period, see accumulateSidechain( ) */
+	void accumulateSidechainFrame(const float* frame, uint32_t numChannels)
+	{
+		for (uint32_t ch = 0; ch < numChannels; ch++)
+		{
+			double a = fabs(frame[ch]);
+			sidechainPeak = fmax(sidechainPeak, a);
+			sidechainSumSquares += a*a;
+		}
+		sidechainCount += numChannels;
+	}
+
+	/** close the current period: its peak, or for MS/RMS detection its RMS (the detector squares it
+	    back), becomes the detector input for the following renders */
+	void finishSidechainPeriod()
+	{
+		if (parameters.sidechain.detectMode == TLD_AUDIO_DETECT_MODE_PEAK)
+			sidechainLevel = sidechainPeak;
+		else
+			sidechainLevel = sidechainCount > 0 ? sqrt(sidechainSumSquares / sidechainCount) : 0.0;
+
+		sidechainPeak = 0.0;
+		sidechainSumSquares = 0.0;
+		sidechainCount = 0;
+	}
 
-			if (params.LFOdPhase == kQUAD_INVERTED_PHASE) { LFOdModifier = output.quadPhaseOutput_neg; }
-			else if (params.LFOdPhase == kNORMAL_PHASE) { LFOdModifier = output.normalOutput; }
-			else if (params.LFOdPhase == kQUAD_PHASE) { LFOdModifier = output.quadPhaseOutput_pos; }
-			else if (params.LFOdPhase == kINVERTED_PHASE) { LFOdModifier = output.invertedOutput; }
-			activeLFOcount++;
+	/** set every periodic lane's phase to the transport phase at sample renderSample */
+	/**
+	\param absoluteSample sample index the musical position belongs to
+	\param renderSample sample index of the next LFO render (may be before the song start)
+	\param quarterNotes musical position at absoluteSample
+	*/
+	void setTransportPhases(uint64_t absoluteSample, int64_t renderSample, double quarterNotes)
+	{
+		double offsetSeconds = (double)(renderSample - (int64_t)absoluteSample) / sampleRate;
+		double renderQuarterNotes = quarterNotes + offsetSeconds * tempoSync.getTempo() / 60.0;
+		double renderSeconds = (double)renderSample / sampleRate;
+
+		for (uint32_t lane = 0; lane < AUTOPAN_NUM_LFOS; lane++)
+		{
+			// --- retriggered LFOs follow the notes, not the transport
+			if (parameters.LFO[lane].trigger != LFOMode::kFreeRun)
+				continue;
+
+			if (tempoSync.isSynced(lane))
+				LFOs.setLanePhase(lane, renderQuarterNotes * tempoSync.getCyclesPerQuarterNote(lane));
+			else
+				LFOs.setLanePhase(lane, renderSeconds * LFOs.getLaneParameters(lane).frequency_Hz);
 		}
+	}
+
+	/** LFO control rate in samples, never less than 1 */
+	uint32_t getLFOControlRate() { return parameters.LFOControlRate > 1 ? parameters.LFOControlRate : 1; }
 
-		if ((params.soloLFOa && params.enableLFOa) || (params.soloLFOb && params.enableLFOb) || (params.soloLFOc && params.enableLFOc) || (params.soloLFOd && params.enableLFOd)) {
-			if (!params.soloLFOa && params.enableLFOa) { LFOaModifier = 0.0; activeLFOcount--; }
-			if (!params.soloLFOb && params.enableLFOb) { LFObModifier = 0.0; activeLFOcount--; }
-			if (!params.soloLFOc && params.enableLFOc) { LFOcModifier = 0.0; activeLFOcount--; }
-			if (!params.soloLFOd && params.enableLFOd) { LFOdModifier = 0.0; activeLFOcount--; }
+	/** render the combined LFO pan modulation for numSamples samples; at control rate the LFOs are
+	    rendered once every LFOControlRate samples and interpolated in between */
+	void renderPanModulation(T* panMod, uint32_t numSamples)
+	{
+		uint32_t controlRate = getLFOControlRate();
+		if (controlRate == 1)
+		{
+			for (uint32_t i = 0; i < numSamples; i++)
+				panMod[i] = renderLFOs();
+			return;
 		}
 
-		double combinedLFOs = 0.0;
-		if (activeLFOcount > 0.0) {
-			combinedLFOs = (LFOaModifier + LFObModifier + LFOcModifier + LFOdModifier) / activeLFOcount;
+		// --- the history holds the LFO values for the control points k-1, k, k+1 and k+2 where
+		//     k is the start of the current control period; rendering ahead means no added latency.
+		//     modControlCounter is already the position in period k (advancePanModulation( ) may
+		//     have moved it while the history was unprimed)
+		if (!modHistoryPrimed)
+		{
+			modHistory[1] = renderLFOs();
+			modHistory[2] = renderLFOs();
+			modHistory[3] = renderLFOs();
+			modHistory[0] = modHistory[1];
+			modHistoryPrimed = true;
 		}
 
-		double panModifier_L = panValue_L * cos((combinedLFOs + 1) * (kPi / 4.0));
-		double panModifier_R = panValue_R * sin((combinedLFOs + 1) * (kPi / 4.0));
+		T controlRateInv = (T)1.0 / controlRate;
+		for (uint32_t i = 0; i < numSamples; i++)
+		{
+			// --- next control period: shift and render one new point
+			if (modControlCounter == controlRate)
+			{
+				modHistory[0] = modHistory[1];
+				modHistory[1] = modHistory[2];
+				modHistory[2] = modHistory[3];
+				modHistory[3] = renderLFOs();
+				modControlCounter = 0;
+			}
+
+			T t = modControlCounter * controlRateInv;
+			if (parameters.LFOInterpolation == modInterpolationType::kCubic)
+			{
+				// --- Catmull-Rom through k-1 .. k+2
+				T a = (T)-0.5*modHistory[0] + (T)1.5*modHistory[1] - (T)1.5*modHistory[2] + (T)0.5*modHistory[3];
+				T b = modHistory[0] - (T)2.5*modHistory[1] + (T)2.0*modHistory[2] - (T)0.5*modHistory[3];
+				T c = (T)0.5*(modHistory[2] - modHistory[0]);
+				panMod[i] = ((a*t + b)*t + c)*t + modHistory[1];
+			}
+			else
+				panMod[i] = modHistory[1] + t*(modHistory[2] - modHistory[1]);
+
+			modControlCounter++;
+		}
+	}
 
-		double gain_L = volumeCooked * panModifier_L;
-		double gain_R = volumeCooked * panModifier_R;
+	/** move the LFOs (and the control rate interpolator) numSamples ahead without rendering; O(1) */
+	void advancePanModulation(uint32_t numSamples)
+	{
+		uint32_t controlRate = getLFOControlRate();
+		if (controlRate == 1)
+		{
+			advanceLFOs(numSamples);
+			return;
+		}
 
-		if (parameters.channelSelection == channelSelectionEnum::kLeft) {
-			gain_R = 0.0;
+		// --- count the control points we would have passed
+		uint32_t total = modControlCounter + numSamples;
+		uint32_t ticks = total / controlRate;
+		modControlCounter = total - ticks*controlRate;
+
+		// --- no history yet: the bank's next render is the start of the current period, the
+		//     samples into it are kept in modControlCounter for when the history is rendered
+		if (!modHistoryPrimed)
+		{
+			advanceLFOs(ticks);
+			return;
 		}
-		else if (parameters.channelSelection == channelSelectionEnum::kRight) {
-			gain_L = 0.0;
+
+		// --- a few points: shift as renderPanModulation( ) would
+		if (ticks <= 3)
+		{
+			for (uint32_t i = 0; i < ticks; i++)
+			{
+				modHistory[0] = modHistory[1];
+				modHistory[1] = modHistory[2];
+				modHistory[2] = modHistory[3];
+				modHistory[3] = renderLFOs();
+			}
+			return;
 		}
 
+		// --- otherwise jump: the bank is three points ahead of the current control point, so
+		//     skip to the new point and render the history from there
+		advanceLFOs(ticks - 3);
+		modHistory[1] = renderLFOs();
+		modHistory[2] = renderLFOs();
+		modHistory[3] = renderLFOs();
+		modHistory[0] = modHistory[1];
+	}
+
+	/** fold M/S decode, static pan, volume, channel select, mute and stereo width into one 2x2 matrix and
+	    start a ramp to it that lasts one control period; the LFO pan gains are applied per sample on top:
+
+		[yL]   [a  b] [modGainL * xL]
+		[yR] = [c  d] [modGainR * xR]
+	*/
+	void cookStereoMatrix()
+	{
+		// --- the M/S decode here is L = mid + side, R = mid - side, which is the identity matrix, so it
+		//     contributes nothing to the product
+		T gain_L = volumeCooked * volumeModGain * panValue_L;
+		T gain_R = volumeCooked * volumeModGain * panValue_R;
+
+		if (parameters.channelSelection == channelSelectionEnum::kLeft)
+			gain_R = (T)0.0;
+		else if (parameters.channelSelection == channelSelectionEnum::kRight)
+			gain_L = (T)0.0;
+
 		if (parameters.enableMute) {
-			gain_L = 0.0;
-			gain_R = 0.0;
+			gain_L = (T)0.0;
+			gain_R = (T)0.0;
 		}
 
-		double stereoWidth = params.stereoWidth;
-		if (stereoWidth < 0.0) { stereoWidth = stereoWidth / 2.0;}
-		
-		double leftImage = ((xnL * gain_L) - (xnR * gain_R)) * (stereoWidth / 100.0);
-		double rightImage = ((xnR * gain_R) - (xnL * gain_L)) * (stereoWidth / 100.0);
+		// --- yL = xL*gL + w*(xL*gL - xR*gR), yR = xR*gR + w*(xR*gR - xL*gL); negative widths are halved
+		double stereoWidth = parameters.stereoWidth + kAutoPanModWidthRange*widthMod;
+		boundValue(stereoWidth, -100.0, 100.0);
+		if (stereoWidth < 0.0) { stereoWidth = stereoWidth / 2.0; }
+		T width = (T)(stereoWidth / 100.0);
+
+		T target[4];
+		target[0] = ((T)1.0 + width) * gain_L;
+		target[1] = -width * gain_R;
+		target[2] = -width * gain_L;
+		target[3] = ((T)1.0 + width) * gain_R;
+
+		uint32_t rampLength = getLFOControlRate();
+		if (stereoMatrixSnap || rampLength == 1)
+		{
+			for (uint32_t k = 0; k < 4; k++) {
+				stereoMatrix[k] = target[k];
+				stereoMatrixInc[k] = (T)0.0;
+			}
+			stereoMatrixRampSamples = 0;
+			stereoMatrixSnap = false;
+			return;
+		}
+
+		// --- ramp from wherever we are now, including part way through a previous ramp
+		for (uint32_t k = 0; k < 4; k++) {
+			stereoMatrixTarget[k] = target[k];
+			stereoMatrixInc[k] = (target[k] - stereoMatrix[k]) / (T)rampLength;
+		}
+		stereoMatrixRampSamples = rampLength;
+	}
 
-		double ynL = (xnL * gain_L) + leftImage;
-		double ynR = (xnR * gain_R) + rightImage;
+	/** the per-sample DSP: apply the (ramping) stereo matrix to the LFO-panned input; branch free inside
+	    each loop so the compiler can vectorize it */
+	/**
+	\param inL left input
+	\param inR right input
+	\param modGainL pan law gains of the LFO modulation, left
+	\param modGainR pan law gains of the LFO modulation, right
+	\param outL left output
+	\param outR right output
+	\param numSamples length of the arrays
+	*/
+	void processStereoMatrix(const float* inL, const float* inR, const T* modGainL, const T* modGainR, float* outL, float* outR, uint32_t numSamples)
+	{
+		uint32_t i = 0;
+
+		// --- ramp part
+		if (stereoMatrixRampSamples > 0)
+		{
+			uint32_t rampEnd = numSamples < stereoMatrixRampSamples ? numSamples : stereoMatrixRampSamples;
+			const T a = stereoMatrix[0], b = stereoMatrix[1], c = stereoMatrix[2], d = stereoMatrix[3];
+			const T da = stereoMatrixInc[0], db = stereoMatrixInc[1], dc = stereoMatrixInc[2], dd = stereoMatrixInc[3];
+			for (; i < rampEnd; i++)
+			{
+				T r = (T)(i + 1);
+				T uL = modGainL[i] * (T)inL[i];
+				T uR = modGainR[i] * (T)inR[i];
+				outL[i] = (float)((a + r*da)*uL + (b + r*db)*uR);
+				outR[i] = (float)((c + r*dc)*uL + (d + r*dd)*uR);
+			}
 
-		outputFrame[0] = ynL;
-		if (outputChannels == 2) {
-			outputFrame[1] = ynR;
+			stereoMatrixRampSamples -= rampEnd;
+			for (uint32_t k = 0; k < 4; k++)
+				stereoMatrix[k] = stereoMatrixRampSamples == 0 ? stereoMatrixTarget[k] : stereoMatrix[k] + (T)rampEnd*stereoMatrixInc[k];
 		}
 
-		parameters.outputMeterL = ynL;
-		parameters.outputMeterR = ynR;
-		
-		return true;
+		// --- constant part
+		const T a = stereoMatrix[0], b = stereoMatrix[1], c = stereoMatrix[2], d = stereoMatrix[3];
+		for (; i < numSamples; i++)
+		{
+			T uL = modGainL[i] * (T)inL[i];
+			T uR = modGainR[i] * (T)inR[i];
+			outL[i] = (float)(a*uL + b*uR);
+			outR[i] = (float)(c*uL + d*uR);
+		}
 	}
 
-	/** get parameters: note use of custom structure for passing param data */
+	/** surround: work out the rotation matrix for the next control point and start a ramp to it that
+	    lasts one control period, then list the matrix entries that are in use; call on the first
+	    sample of a control period, after renderPanModulation( ) has rendered it */
 	/**
-	\return AutoPanParameters custom data structure
+	\param panModNow the pan modulation of that sample (used at full control rate)
 	*/
-	AutoPanParameters getParameters()
+	void cookSurroundMatrix(T panModNow)
 	{
-		return parameters;
+		uint32_t controlRate = getLFOControlRate();
+		if (surroundMatrixSnap || controlRate == 1)
+		{
+			// --- at control rate the history holds this control point's value
+			calculateSurroundGains(controlRate == 1 ? panModNow : modHistory[1], surroundMatrix);
+			for (uint32_t in = 0; in < VBAP_MAX_SPEAKERS; in++) {
+				for (uint32_t out = 0; out < VBAP_MAX_SPEAKERS; out++) {
+					surroundMatrixTarget[in][out] = surroundMatrix[in][out];
+					surroundMatrixInc[in][out] = (T)0.0;
+				}
+			}
+			surroundMatrixRampSamples = 0;
+			surroundMatrixSnap = false;
+		}
+
+		if (controlRate > 1)
+		{
+			calculateSurroundGains(modHistory[2], surroundMatrixTarget);
+			for (uint32_t in = 0; in < VBAP_MAX_SPEAKERS; in++)
+				for (uint32_t out = 0; out < VBAP_MAX_SPEAKERS; out++)
+					surroundMatrixInc[in][out] = (surroundMatrixTarget[in][out] - surroundMatrix[in][out]) / (T)controlRate;
+			surroundMatrixRampSamples = controlRate;
+		}
+
+		// --- each input feeds at most two speakers (four while it moves to a new pair) plus the LFE,
+		//     so only those entries are run
+		numSurroundTaps = 0;
+		for (uint32_t in = 0; in < VBAP_MAX_SPEAKERS; in++)
+		{
+			for (uint32_t out = 0; out < VBAP_MAX_SPEAKERS; out++)
+			{
+				if (surroundMatrix[in][out] == (T)0.0 && surroundMatrixTarget[in][out] == (T)0.0)
+					continue;
+				surroundTapInput[numSurroundTaps] = in;
+				surroundTapOutput[numSurroundTaps] = out;
+				numSurroundTaps++;
+			}
+		}
 	}
 
-	/** set parameters: note use of custom structure for passing param data */
+	/** surround: the input to output gains for one pan value; each input channel is moved round the
+	    ring from its own speaker position and placed with VBAP, the LFE goes to the LFE */
 	/**
-	\param AutoPanParameters custom data structure
+	\param panMod pan modulation; added to the static pan, +/-1.0 = half a turn
+	\param matrix returned gains, [input][output]
 	*/
-	void setParameters(const AutoPanParameters& params)
+	void calculateSurroundGains(T panMod, T matrix[VBAP_MAX_SPEAKERS][VBAP_MAX_SPEAKERS])
 	{
-		// --- copy them; note you may choose to ignore certain items
-		//     and copy the variables one at a time, or you may test
-		//     to see if cook-able variables have changed; if not, then
-		//     do not re-cook them as it just wastes CPU
-		parameters = params;
+		for (uint32_t in = 0; in < VBAP_MAX_SPEAKERS; in++)
+			for (uint32_t out = 0; out < VBAP_MAX_SPEAKERS; out++)
+				matrix[in][out] = (T)0.0;
+
+		T gain = parameters.enableMute ? (T)0.0 : volumeCooked * volumeModGain;
+
+		// --- positive pan turns clockwise (to the right), like the stereo pan
+		double rotation = -180.0*(parameters.panValue + (double)panMod);
+
+		for (uint32_t in = 0; in < surroundInputs.numChannels; in++)
+		{
+			if ((int32_t)in == surroundInputs.lfeChannel)
+			{
+				if (surroundOutputs.lfeChannel >= 0)
+					matrix[in][surroundOutputs.lfeChannel] = gain;
+				continue;
+			}
 
-		// --- if dB = -60, then we shut off completely
-		if (parameters.volume_dB == -60.0) {
-			volumeCooked = 0.0;
+			uint32_t speakerA = 0;
+			uint32_t speakerB = 0;
+			double gainA = 0.0;
+			double gainB = 0.0;
+			outputPanner.calculateGains(surroundInputs.azimuth[in] + rotation, speakerA, speakerB, gainA, gainB);
+			matrix[in][speakerA] += gain * (T)gainA;
+			matrix[in][speakerB] += gain * (T)gainB;
 		}
-		else {
-			volumeCooked = pow(10.0, parameters.volume_dB / 20.0);
+	}
+
+	/** surround: the per-sample DSP, a sparse matrix multiply with a linear gain ramp; one
+	    multiply-add loop per entry in use, branch free so the compiler can vectorize it */
+	/**
+	\param inputs array of input channel buffers
+	\param outputs array of output channel buffers
+	\param startFrame first frame to process
+	\param numFrames frames to process
+	\param inputChannels number of input channels
+	\param outputChannels number of output channels
+	*/
+	void processSurroundMatrix(const float* const* inputs, float** outputs, uint32_t startFrame, uint32_t numFrames,
+							   uint32_t inputChannels, uint32_t outputChannels)
+	{
+		// --- outputs are summed into; outputs past the layout stay silent
+		for (uint32_t ch = 0; ch < outputChannels; ch++)
+			memset(outputs[ch] + startFrame, 0, sizeof(float)*numFrames);
+
+		uint32_t rampEnd = numFrames < surroundMatrixRampSamples ? numFrames : surroundMatrixRampSamples;
+		bool rampDone = rampEnd == surroundMatrixRampSamples;
+
+		for (uint32_t k = 0; k < numSurroundTaps; k++)
+		{
+			uint32_t in = surroundTapInput[k];
+			uint32_t out = surroundTapOutput[k];
+			if (in >= inputChannels || out >= outputChannels)
+				continue;
+
+			const float* x = inputs[in] + startFrame;
+			float* y = outputs[out] + startFrame;
+			const T g = surroundMatrix[in][out];
+			const T dg = surroundMatrixInc[in][out];
+
+			uint32_t i = 0;
+			for (; i < rampEnd; i++)
+				y[i] += (float)((g + (T)(i + 1)*dg) * (T)x[i]);
+
+			const T gEnd = rampDone ? surroundMatrixTarget[in][out] : g + (T)rampEnd*dg;
+			for (; i < numFrames; i++)
+				y[i] += (float)(gEnd * (T)x[i]);
 		}
 
-		// --- constant power panning
-		if (parameters.panValue != prevParameters.panValue) {
-			panValue_L = cos((parameters.panValue + 1.0) * (kPi / 4.0));
-			panValue_R = sin((parameters.panValue + 1.0) * (kPi / 4.0));
+		// --- move the entries in use along the ramp; the others are zero at both ends
+		surroundMatrixRampSamples -= rampEnd;
+		for (uint32_t k = 0; k < numSurroundTaps; k++)
+		{
+			uint32_t in = surroundTapInput[k];
+			uint32_t out = surroundTapOutput[k];
+			surroundMatrix[in][out] = rampDone ? surroundMatrixTarget[in][out] : surroundMatrix[in][out] + (T)rampEnd*surroundMatrixInc[in][out];
 		}
+	}
 
-		prevParameters = parameters;
+	/** convert the GUI waveform index into the LFO's waveform; unknown values leave it unchanged */
+	static LFOWaveform convertLFOWaveform(int waveform, LFOWaveform current)
+	{
+		if (waveform == _kSIN) { return LFOWaveform::kSin; }
+		else if (waveform == _kTRIANGLE) { return LFOWaveform::kTriangle; }
+		else if (waveform == _kSAW) { return LFOWaveform::kSaw; }
+		else if (waveform == _kQRSH) { return LFOWaveform::kQRSH; }
+		return current;
 	}
 
-private:
-	AutoPanParameters parameters; ///< object parameters
-	AutoPanParameters prevParameters; ///< previous frame's parameters
+	/** convert the GUI phase index into the LFO output selection */
+	static LFOPhaseOutput convertLFOPhase(int phase)
+	{
+		if (phase == kQUAD_PHASE) { return LFOPhaseOutput::kQuadPhase; }
+		else if (phase == kINVERTED_PHASE) { return LFOPhaseOutput::kInverted; }
+		else if (phase == kQUAD_INVERTED_PHASE) { return LFOPhaseOutput::kQuadPhaseInverted; }
+		return LFOPhaseOutput::kNormal;
+	}
 
-	SuperLFO LFOa;
-	SuperLFO LFOb;
-	SuperLFO LFOc;
-	SuperLFO LFOd;
+	AutoPanParameters parameters; ///< object parameters
 
-	SuperLFOParameters LFOaParams;
-	SuperLFOParameters LFObParams;
-	SuperLFOParameters LFOcParams;
-	SuperLFOParameters LFOdParams;
+	SuperLFOBank<AUTOPAN_NUM_LFOS, T> LFOs;	///< LFO 'A' is lane 0, 'B' lane 1, etc...
+	TempoSync<AUTOPAN_NUM_LFOS> tempoSync;	///< cached increments of the tempo synced lanes
 
 	// --- local variables used by this object
 	double sampleRate = 0.0;	///< sample rate
 
-	double volumeCooked = 1.0; ///< unity gain
-	double panValue_L = 0.707; ///< center cooked value
-	double panValue_R = 0.707; ///< center cooked value
+	T volumeCooked = (T)1.0; ///< unity gain
+	T panValue_L = (T)0.707; ///< center cooked value
+	T panValue_R = (T)0.707; ///< center cooked value
+
+	// --- fused M/S decode, pan, volume, channel select, mute and width
+	T stereoMatrix[4] = { (T)1.0, (T)0.0, (T)0.0, (T)1.0 };	///< current matrix a, b, c, d
+	T stereoMatrixTarget[4] = { (T)1.0, (T)0.0, (T)0.0, (T)1.0 };	///< where the ramp ends
+	T stereoMatrixInc[4] = { (T)0.0, (T)0.0, (T)0.0, (T)0.0 };	///< per-sample ramp step
+	uint32_t stereoMatrixRampSamples = 0;	///< samples left in the ramp; 0 = not ramping
+	bool stereoMatrixSnap = true;	///< true = jump straight to the next matrix (first cook after reset)
+
+	// --- control rate LFO interpolation
+	T modHistory[4] = { (T)0.0, (T)0.0, (T)0.0, (T)0.0 };	///< combined LFO values at control points k-1, k, k+1, k+2
+	uint32_t modControlCounter = 0;	///< samples into the current control period
+	bool modHistoryPrimed = false;	///< false = render the history before the next sample
+
+	// --- modulation matrix
+	ModulationMatrix<AUTOPAN_NUM_MOD_SOURCES, AUTOPAN_NUM_MOD_DESTINATIONS, T> modMatrix;	///< the active routes
+	bool modDrivesStereo = false;	///< width or volume is modulated: the stereo matrix is re-cooked every LFO render
+	bool modDrivesLFOs = false;		///< at least one LFO rate or depth is modulated
+	bool laneModulated[AUTOPAN_NUM_LFOS] = {};	///< per-LFO: rate or depth is modulated
+	T widthMod = (T)0.0;			///< width modulation, 1.0 = +kAutoPanModWidthRange
+	T volumeModGain = (T)1.0;		///< volume modulation as a gain
+
+	// --- sidechain
+	AudioDetector sidechainDetector;	///< sidechain envelope, clocked by the LFO renders
+	double sidechainLevel = 0.0;		///< detector input: peak or RMS of the last complete control period
+	double sidechainPeak = 0.0;			///< current period: peak
+	double sidechainSumSquares = 0.0;	///< current period: sum of squares
+	uint64_t sidechainCount = 0;		///< current period: samples (times channels) accumulated
+	const float* sidechainFrame = nullptr;	///< see setSidechainFrame( )
+	uint32_t sidechainFrameChannels = 0;	///< see setSidechainFrame( )
+	bool sidechainActive = false;		///< a route reads the sidechain
+
+	// --- surround rotation
+	uint32_t surroundInputFormat = kCFStereo;	///< see setChannelFormats( )
+	uint32_t surroundOutputFormat = kCFStereo;	///< see setChannelFormats( )
+	bool surroundActive = false;				///< the outputs are a surround layout
+	SpeakerLayout surroundInputs;				///< input channel positions
+	SpeakerLayout surroundOutputs;				///< output speaker positions
+	VBAPPanner outputPanner;					///< VBAP over the output ring
+	T surroundMatrix[VBAP_MAX_SPEAKERS][VBAP_MAX_SPEAKERS] = {};		///< current gains, [input][output]
+	T surroundMatrixTarget[VBAP_MAX_SPEAKERS][VBAP_MAX_SPEAKERS] = {};	///< where the ramp ends
+	T surroundMatrixInc[VBAP_MAX_SPEAKERS][VBAP_MAX_SPEAKERS] = {};		///< per-sample ramp step
+	uint32_t surroundMatrixRampSamples = 0;		///< samples left in the ramp; 0 = not ramping
+	bool surroundMatrixSnap = true;				///< true = jump straight to the next matrix
+	uint32_t numSurroundTaps = 0;				///< matrix entries in use
+	uint32_t surroundTapInput[VBAP_MAX_SPEAKERS*VBAP_MAX_SPEAKERS] = {};	///< per entry in use: input
+	uint32_t surroundTapOutput[VBAP_MAX_SPEAKERS*VBAP_MAX_SPEAKERS] = {};	///< per entry in use: output
+
+	// --- transport lock
+	bool transportLocked = false;	///< true once syncToTransport( ) has placed the LFOs
+	uint64_t transportSample = 0;	///< sample index of the next frame, to spot transport jumps
 
 };
 
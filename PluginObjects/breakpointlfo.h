@@ -0,0 +1,239 @@
+#pragma once
+
+#ifndef __BreakpointLFO__
+#define __BreakpointLFO__
+
+#include "superlfo.h"
+#include <atomic>
+
+// --- most points a breakpoint shape can have
+const uint32_t LFO_MAX_BREAKPOINTS = 8;
+
+// --- a segment curve of +/-1 bends the segment as far as exp(+/-kLFOBreakpointMaxBend*t)
+const double kLFOBreakpointMaxBend = 8.0;
+
+/**
+\struct LFOBreakpoint
+\ingroup FX-Objects
+\brief
+One point of a breakpoint LFO shape, plus the curve of the segment that starts at it.
+*/
+struct LFOBreakpoint
+{
+	double phase = 0.0;	///< position in the cycle, 0.0 to 1.0
+	double level = 0.0;	///< LFO value at the point, -1.0 to +1.0
+	double curve = 0.0;	///< bend of the segment to the next point, -1.0 to +1.0; 0.0 is a straight line
+};
+
+/**
+\class LFOBreakpointCurve
+\ingroup FX-Objects
+\brief
+The LFOBreakpointCurve object describes a user drawn LFO cycle: up to LFO_MAX_BREAKPOINTS points,
+joined by straight or curved segments, with the last point joined back to the first across the wrap.
+
+The curve is not evaluated on the audio thread. compile( ) samples it into an LFOWavetable, which the
+LFOs read like the built in shapes (one interpolated table read per render, no segment search).
+Compile off the audio thread and hand the table over with an LFOWavetableExchange.
+
+Control I/F:
+- setNumPoints( ), setPoint( ); the points may be given in any order.
+
+\author <Aaron Mutchler> <http://www.aaronmutchler.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+class LFOBreakpointCurve
+{
+public:
+	LFOBreakpointCurve(void) {}	/* C-TOR */
+	~LFOBreakpointCurve(void) {}	/* D-TOR */
+
+	/** set how many of the points are used */
+	/**
+	\param _numPoints 1 to LFO_MAX_BREAKPOINTS
+	*/
+	void setNumPoints(uint32_t _numPoints)
+	{
+		numPoints = _numPoints < 1 ? 1 : _numPoints > LFO_MAX_BREAKPOINTS ? LFO_MAX_BREAKPOINTS : _numPoints;
+	}
+
+	/** number of points used */
+	uint32_t getNumPoints() const { return numPoints; }
+
+	/** set one point; values are clamped to their ranges */
+	/**
+	\param index 0 to LFO_MAX_BREAKPOINTS - 1
+	\param point the point and the curve of the segment that leaves it
+	*/
+	void setPoint(uint32_t index, const LFOBreakpoint& point)
+	{
+		if (index >= LFO_MAX_BREAKPOINTS) return;
+		points[index] = point;
+		boundValue(points[index].phase, 0.0, 1.0);
+		boundValue(points[index].level, -1.0, 1.0);
+		boundValue(points[index].curve, -1.0, 1.0);
+	}
+
+	/** get one point */
+	LFOBreakpoint getPoint(uint32_t index) const { return index < LFO_MAX_BREAKPOINTS ? points[index] : LFOBreakpoint(); }
+
+	/** evaluate the curve; for drawing it, the audio thread reads the compiled table */
+	/**
+	\param phase 0.0 to 1.0
+	\return the curve value, -1.0 to +1.0
+	*/
+	double evaluate(double phase) const
+	{
+		LFOBreakpoint sorted[LFO_MAX_BREAKPOINTS + 1];
+		uint32_t count = getSortedPoints(sorted);
+		return evaluateSorted(sorted, count, phase);
+	}
+
+	/** sample one cycle into a wavetable */
+	/**
+	\param table the table to fill
+	\param length number of samples in the cycle
+	*/
+	void compile(LFOWavetable& table, uint32_t length = kLFOWavetableLength) const
+	{
+		if (length == 0) return;
+
+		LFOBreakpoint sorted[LFO_MAX_BREAKPOINTS + 1];
+		uint32_t count = getSortedPoints(sorted);
+
+		cycle.resize(length);
+		for (uint32_t i = 0; i < length; i++)
+			cycle[i] = evaluateSorted(sorted, count, (double)i / length);
+
+		// --- the cycle is continuous across the wrap, so the end point is the first
+		table.setTable(&cycle[0], length);
+	}
+
+protected:
+	LFOBreakpoint points[LFO_MAX_BREAKPOINTS];	///< the points, in any order
+	uint32_t numPoints = 1;						///< points used
+	mutable std::vector<double> cycle;			///< compile( ) scratch
+
+	/** copy the used points in phase order and append the first again one cycle on, closing the loop */
+	uint32_t getSortedPoints(LFOBreakpoint* sorted) const
+	{
+		for (uint32_t i = 0; i < numPoints; i++)
+			sorted[i] = points[i];
+
+		// --- insertion sort; a handful of points, stable so equal phases keep their order (a vertical step)
+		for (uint32_t i = 1; i < numPoints; i++)
+		{
+			LFOBreakpoint point = sorted[i];
+			uint32_t j = i;
+			for (; j > 0 && sorted[j - 1].phase > point.phase; j--)
+				sorted[j] = sorted[j - 1];
+			sorted[j] = point;
+		}
+
+		sorted[numPoints] = sorted[0];
+		sorted[numPoints].phase += 1.0;
+		return numPoints;
+	}
+
+	/** value at phase of the closed, sorted point list from getSortedPoints( ) */
+	static double evaluateSorted(const LFOBreakpoint* sorted, uint32_t count, double phase)
+	{
+		// --- before the first point we are on the segment that wraps round from the last
+		if (phase < sorted[0].phase)
+			phase += 1.0;
+
+		uint32_t segment = count - 1;
+		for (uint32_t i = 0; i + 1 < count; i++)
+		{
+			if (phase < sorted[i + 1].phase)
+			{
+				segment = i;
+				break;
+			}
+		}
+
+		const LFOBreakpoint& start = sorted[segment];
+		const LFOBreakpoint& end = sorted[segment + 1];
+		double width = end.phase - start.phase;
+		double t = width > 0.0 ? (phase - start.phase) / width : 1.0;
+		if (t > 1.0) t = 1.0;
+
+		return start.level + (end.level - start.level)*bendSegment(t, start.curve);
+	}
+
+	/** shape a 0..1 segment position: straight for curve 0, exponential towards +/-1 */
+	static double bendSegment(double t, double curve)
+	{
+		double k = curve*kLFOBreakpointMaxBend;
+		if (fabs(k) < 1.0e-6)
+			return t;
+		return (exp(k*t) - 1.0) / (exp(k) - 1.0);
+	}
+};
+
+/**
+\class LFOWavetableExchange
+\ingroup FX-Objects
+\brief
+The LFOWavetableExchange object hands wavetables from one writer thread (e.g. the GUI) to one reader
+thread (the audio thread) without locks or allocation on the reader side.
+
+It is a triple buffer: the writer fills its own table and publishes it, which swaps it with the
+middle table in one atomic exchange; the reader, when a new table is waiting, swaps its table with
+the middle one the same way. Neither side ever waits, and the table the reader holds is never
+written until the reader gives it back, so it is safe to play until the next acquire( ).
+
+Writer:
+- fill getWriteTable( ), then publish( )
+
+Reader:
+- acquire( ) once per buffer; use the returned table until the next acquire( )
+
+\author <Aaron Mutchler> <http://www.aaronmutchler.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+class LFOWavetableExchange
+{
+public:
+	LFOWavetableExchange(void) {}	/* C-TOR */
+	~LFOWavetableExchange(void) {}	/* D-TOR */
+
+	/** writer: the table to fill; it belongs to the writer until publish( ) */
+	LFOWavetable& getWriteTable() { return tables[writeIndex]; }
+
+	/** writer: hand the filled table over; the writer gets another table to fill next time */
+	void publish()
+	{
+		uint32_t old = middle.exchange(writeIndex | kFreshFlag, std::memory_order_acq_rel);
+		writeIndex = old & kIndexMask;
+	}
+
+	/** reader: pick up the newest published table, if there is one */
+	/**
+	\return the table to play until the next acquire( ), or nullptr if nothing was ever published
+	*/
+	const LFOWavetable* acquire()
+	{
+		if (middle.load(std::memory_order_relaxed) & kFreshFlag)
+		{
+			uint32_t old = middle.exchange(readIndex, std::memory_order_acq_rel);
+			readIndex = old & kIndexMask;
+		}
+		return tables[readIndex].getLength() > 0 ? &tables[readIndex] : nullptr;
+	}
+
+protected:
+	static const uint32_t kIndexMask = 3;	///< middle: table index
+	static const uint32_t kFreshFlag = 4;	///< middle: published and not yet picked up
+
+	LFOWavetable tables[3];					///< write, middle and read tables
+	std::atomic<uint32_t> middle{ 1 };		///< index of the middle table plus kFreshFlag
+	uint32_t writeIndex = 0;				///< writer's table
+	uint32_t readIndex = 2;					///< reader's table
+};
+
+#endif
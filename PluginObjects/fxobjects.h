@@ -1883,22 +1883,39 @@ public:
 		// --- store envelope prior to sqrt for RMS version
 		lastEnvelope = currEnvelope;
 
-		// --- if RMS, do the SQRT
-		if (audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS)
-			currEnvelope = pow(currEnvelope, 0.5);
+		return getDetectorOutput(currEnvelope);
+	}
 
-		// --- if not dB, we are done
-		if (!audioDetectorParameters.detect_dB)
-			return currEnvelope;
+	// --- process numSamples samples of the same input in O(1): with a constant input the envelope
+	//     only moves one way, so the attack or release one-pole has the closed form
+	//     input + (envelope - input)*coeff^n
+	/**
+	\param xn input, held for all numSamples samples
+	\param numSamples number of samples
+	\return what processAudioSample( ) would return for the last of them
+	*/
+	double processConstantInput(double xn, uint64_t numSamples)
+	{
+		if (numSamples == 0)
+			return getDetectorOutput(lastEnvelope);
 
-		// --- setup for log( )
-		if (currEnvelope <= 0)
-		{
-			return -96.0;
-		}
+		// --- same rectification as processAudioSample( )
+		double input = fabs(xn);
+		if (audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_MS ||
+			audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS)
+			input *= input;
 
-		// --- true log output in dB, can go above 0dBFS!
-		return 20.0*log10(currEnvelope);
+		double coeff = input > lastEnvelope ? attackTime : releaseTime;
+		double currEnvelope = input + (lastEnvelope - input)*pow(coeff, (double)numSamples);
+
+		// --- the clamps hold for every step of a monotonic run, so applying them once is the same
+		checkFloatUnderflow(currEnvelope);
+		if (audioDetectorParameters.clampToUnityMax)
+			currEnvelope = fmin(currEnvelope, 1.0);
+		currEnvelope = fmax(currEnvelope, 0.0);
+
+		lastEnvelope = currEnvelope;
+		return getDetectorOutput(currEnvelope);
 	}
 
 	/** get parameters: note use of custom structure for passing param data */
@@ -1949,6 +1966,27 @@ protected:
 
 	/** set our internal release time coefficients based on times and sample rate */
 	void setReleaseTime(double release_in_ms, bool forceCalc = false);
+
+	/** the detector output for an envelope value: the SQRT for RMS, then dB if asked for */
+	double getDetectorOutput(double currEnvelope)
+	{
+		// --- if RMS, do the SQRT
+		if (audioDetectorParameters.detectMode == TLD_AUDIO_DETECT_MODE_RMS)
+			currEnvelope = pow(currEnvelope, 0.5);
+
+		// --- if not dB, we are done
+		if (!audioDetectorParameters.detect_dB)
+			return currEnvelope;
+
+		// --- setup for log( )
+		if (currEnvelope <= 0)
+		{
+			return -96.0;
+		}
+
+		// --- true log output in dB, can go above 0dBFS!
+		return 20.0*log10(currEnvelope);
+	}
 };
 
 
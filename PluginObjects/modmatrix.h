@@ -0,0 +1,112 @@
+#pragma once
+
+#ifndef __ModMatrix__
+#define __ModMatrix__
+
+#include <stdint.h>
+
+/**
+\class ModulationMatrix
+\ingroup FX-Objects
+\brief
+The ModulationMatrix object routes NUM_SOURCES modulation sources to NUM_DESTINATIONS destinations,
+each route with its own amount; a destination fed by several routes gets their sum.
+
+The matrix is sparse: only the routes that are set (non-zero amount) are kept, compacted into short
+arrays when the routing changes, so evaluate( ) costs one multiply-add per active route however big
+the full source x destination grid is. Evaluate it at control rate.
+
+Control I/F:
+- clearRoutes( ), then addRoute( ) for each connection; call from the same thread as evaluate( ).
+
+\author <Aaron Mutchler> <http://www.aaronmutchler.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+template <uint32_t NUM_SOURCES, uint32_t NUM_DESTINATIONS, typename T = double>
+class ModulationMatrix
+{
+public:
+	ModulationMatrix(void) {}	/* C-TOR */
+	~ModulationMatrix(void) {}	/* D-TOR */
+
+	// --- one route per source/destination pair at most
+	static const uint32_t kMaxRoutes = NUM_SOURCES * NUM_DESTINATIONS;
+
+	/** remove every route */
+	void clearRoutes()
+	{
+		numRoutes = 0;
+		for (uint32_t s = 0; s < NUM_SOURCES; s++)
+			sourceActive[s] = false;
+		for (uint32_t d = 0; d < NUM_DESTINATIONS; d++)
+			destinationActive[d] = false;
+	}
+
+	/** add a route; a second route between the same pair adds to the first */
+	/**
+	\param source 0 to NUM_SOURCES - 1
+	\param destination 0 to NUM_DESTINATIONS - 1
+	\param amount scale applied to the source; 0.0 routes are not stored
+	\return true if the route is active
+	*/
+	bool addRoute(uint32_t source, uint32_t destination, double amount)
+	{
+		if (source >= NUM_SOURCES || destination >= NUM_DESTINATIONS || amount == 0.0)
+			return false;
+
+		for (uint32_t r = 0; r < numRoutes; r++)
+		{
+			if (routeSource[r] == source && routeDestination[r] == destination)
+			{
+				routeAmount[r] += (T)amount;
+				return true;
+			}
+		}
+
+		if (numRoutes >= kMaxRoutes)
+			return false;
+
+		routeSource[numRoutes] = source;
+		routeDestination[numRoutes] = destination;
+		routeAmount[numRoutes] = (T)amount;
+		numRoutes++;
+		sourceActive[source] = true;
+		destinationActive[destination] = true;
+		return true;
+	}
+
+	/** number of active routes */
+	uint32_t getNumRoutes() { return numRoutes; }
+
+	/** true if at least one route reads the source; sources that are not read need not be computed */
+	bool isSourceActive(uint32_t source) { return source < NUM_SOURCES && sourceActive[source]; }
+
+	/** true if at least one route feeds the destination */
+	bool isDestinationActive(uint32_t destination) { return destination < NUM_DESTINATIONS && destinationActive[destination]; }
+
+	/** run the routes */
+	/**
+	\param sources NUM_SOURCES source values
+	\param destinations returned NUM_DESTINATIONS values; 0.0 for destinations with no route
+	*/
+	inline void evaluate(const T* sources, T* destinations)
+	{
+		for (uint32_t d = 0; d < NUM_DESTINATIONS; d++)
+			destinations[d] = (T)0.0;
+
+		for (uint32_t r = 0; r < numRoutes; r++)
+			destinations[routeDestination[r]] += routeAmount[r] * sources[routeSource[r]];
+	}
+
+protected:
+	uint32_t numRoutes = 0;							///< active routes, packed at the front of the arrays
+	uint32_t routeSource[kMaxRoutes] = {};			///< per-route source index
+	uint32_t routeDestination[kMaxRoutes] = {};		///< per-route destination index
+	T routeAmount[kMaxRoutes] = {};					///< per-route amount
+	bool sourceActive[NUM_SOURCES] = {};			///< sources read by at least one route
+	bool destinationActive[NUM_DESTINATIONS] = {};	///< destinations fed by at least one route
+};
+
+#endif
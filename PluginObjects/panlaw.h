@@ -0,0 +1,267 @@
+#pragma once
+
+#ifndef __PanLaw__
+#define __PanLaw__
+
+#include <math.h>
+#include <stdint.h>
+
+// --- SSE2 is always there on x64 and on x86 builds with /arch:SSE2 or better
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PANLAW_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/**
+\enum panLawType
+\ingroup FX-Objects
+\brief
+The pan laws offered by the pan law engine; the name is the gain at center.
+
+- k3dB: equal power, gL = cos(theta), gR = sin(theta)
+- k4p5dB: compromise, gL = cos(theta)^1.5, gR = sin(theta)^1.5
+- k6dB: equal amplitude (smooth), gL = cos(theta)^2, gR = sin(theta)^2
+- kLinear: equal amplitude (straight line), gL = 1 - x, gR = x
+
+where x = (pan + 1)/2 is in [0, 1] and theta = x * pi/2
+*/
+enum class panLawType { k3dB, k4p5dB, k6dB, kLinear };
+
+// --- Taylor coefficients for sin(x), x^1 through x^11
+const double kPanLawSin1 = 1.0;
+const double kPanLawSin3 = -1.0 / 6.0;
+const double kPanLawSin5 = 1.0 / 120.0;
+const double kPanLawSin7 = -1.0 / 5040.0;
+const double kPanLawSin9 = 1.0 / 362880.0;
+const double kPanLawSin11 = -1.0 / 39916800.0;
+
+const double kPanLawHalfPi = 1.57079632679489661923;
+
+/**
+@fastSinQuadrant
+\ingroup FX-Functions
+
+@brief sin(theta) for theta on [0, pi/2] using an 11th order odd polynomial
+
+- the series alternates, so the error is below theta^13/13! which is 5.7e-8 at pi/2 (about -145 dB)
+- cos(theta) is fastSinQuadrant(pi/2 - theta); the pan gains built from it are within 1.2e-7 of libm for every law
+- in float the error is float rounding (about 1e-7), so the same polynomial serves both
+
+\param theta angle in radians, [0, pi/2]
+\return sin(theta)
+*/
+template <typename T>
+inline T fastSinQuadrant(T theta)
+{
+	T x2 = theta*theta;
+	return theta*((T)kPanLawSin1 + x2*((T)kPanLawSin3 + x2*((T)kPanLawSin5 + x2*((T)kPanLawSin7 + x2*((T)kPanLawSin9 + x2*(T)kPanLawSin11)))));
+}
+
+/**
+@calculatePanGains
+\ingroup FX-Functions
+
+@brief calculate the left and right gains for one pan position
+
+\param law the pan law to use
+\param pan pan position, -1 (hard left) to +1 (hard right); values outside are clamped
+\param gainL returned left gain
+\param gainR returned right gain
+*/
+template <typename T>
+inline void calculatePanGains(panLawType law, T pan, T& gainL, T& gainR)
+{
+	T x = (T)0.5*(pan + (T)1.0);
+	if (x < (T)0.0) x = (T)0.0;
+	else if (x > (T)1.0) x = (T)1.0;
+
+	if (law == panLawType::kLinear)
+	{
+		gainL = (T)1.0 - x;
+		gainR = x;
+		return;
+	}
+
+	T theta = x*(T)kPanLawHalfPi;
+	T c = fastSinQuadrant((T)kPanLawHalfPi - theta);
+	T s = fastSinQuadrant(theta);
+
+	if (law == panLawType::k4p5dB)
+	{
+		gainL = c*sqrt(c);
+		gainR = s*sqrt(s);
+	}
+	else if (law == panLawType::k6dB)
+	{
+		gainL = c*c;
+		gainR = s*s;
+	}
+	else
+	{
+		gainL = c;
+		gainR = s;
+	}
+}
+
+#ifdef PANLAW_USE_SSE2
+/** two-lane version of fastSinQuadrant( ) */
+inline __m128d fastSinQuadrant(__m128d theta)
+{
+	__m128d x2 = _mm_mul_pd(theta, theta);
+	__m128d p = _mm_set1_pd(kPanLawSin11);
+	p = _mm_add_pd(_mm_mul_pd(p, x2), _mm_set1_pd(kPanLawSin9));
+	p = _mm_add_pd(_mm_mul_pd(p, x2), _mm_set1_pd(kPanLawSin7));
+	p = _mm_add_pd(_mm_mul_pd(p, x2), _mm_set1_pd(kPanLawSin5));
+	p = _mm_add_pd(_mm_mul_pd(p, x2), _mm_set1_pd(kPanLawSin3));
+	p = _mm_add_pd(_mm_mul_pd(p, x2), _mm_set1_pd(kPanLawSin1));
+	return _mm_mul_pd(p, theta);
+}
+#endif
+
+/**
+@calculatePanGains
+\ingroup FX-Functions
+
+@brief calculate the left and right gains for a whole buffer of pan positions (e.g. a modulation buffer);
+       uses SSE2 two lanes at a time when available and gives the same results as the single value version
+
+\param law the pan law to use
+\param pan array of pan positions, -1 to +1
+\param gainL returned left gains
+\param gainR returned right gains
+\param numSamples length of the arrays
+*/
+inline void calculatePanGains(panLawType law, const double* pan, double* gainL, double* gainR, uint32_t numSamples)
+{
+	uint32_t i = 0;
+
+#ifdef PANLAW_USE_SSE2
+	const __m128d half = _mm_set1_pd(0.5);
+	const __m128d one = _mm_set1_pd(1.0);
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d halfPi = _mm_set1_pd(kPanLawHalfPi);
+
+	for (; i + 2 <= numSamples; i += 2)
+	{
+		__m128d x = _mm_mul_pd(half, _mm_add_pd(_mm_loadu_pd(pan + i), one));
+		x = _mm_min_pd(_mm_max_pd(x, zero), one);
+
+		__m128d left, right;
+		if (law == panLawType::kLinear)
+		{
+			left = _mm_sub_pd(one, x);
+			right = x;
+		}
+		else
+		{
+			__m128d theta = _mm_mul_pd(x, halfPi);
+			__m128d c = fastSinQuadrant(_mm_sub_pd(halfPi, theta));
+			__m128d s = fastSinQuadrant(theta);
+
+			if (law == panLawType::k4p5dB)
+			{
+				left = _mm_mul_pd(c, _mm_sqrt_pd(c));
+				right = _mm_mul_pd(s, _mm_sqrt_pd(s));
+			}
+			else if (law == panLawType::k6dB)
+			{
+				left = _mm_mul_pd(c, c);
+				right = _mm_mul_pd(s, s);
+			}
+			else
+			{
+				left = c;
+				right = s;
+			}
+		}
+		_mm_storeu_pd(gainL + i, left);
+		_mm_storeu_pd(gainR + i, right);
+	}
+#endif
+
+	// --- leftovers (or everything, without SSE2)
+	for (; i < numSamples; i++)
+		calculatePanGains(law, pan[i], gainL[i], gainR[i]);
+}
+
+#ifdef PANLAW_USE_SSE2
+/** four-lane single precision version of fastSinQuadrant( ) */
+inline __m128 fastSinQuadrant(__m128 theta)
+{
+	__m128 x2 = _mm_mul_ps(theta, theta);
+	__m128 p = _mm_set1_ps((float)kPanLawSin11);
+	p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps((float)kPanLawSin9));
+	p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps((float)kPanLawSin7));
+	p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps((float)kPanLawSin5));
+	p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps((float)kPanLawSin3));
+	p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps((float)kPanLawSin1));
+	return _mm_mul_ps(p, theta);
+}
+#endif
+
+/**
+@calculatePanGains
+\ingroup FX-Functions
+
+@brief single precision version of the buffer pan gain calculation; SSE runs four lanes at a time
+
+\param law the pan law to use
+\param pan array of pan positions, -1 to +1
+\param gainL returned left gains
+\param gainR returned right gains
+\param numSamples length of the arrays
+*/
+inline void calculatePanGains(panLawType law, const float* pan, float* gainL, float* gainR, uint32_t numSamples)
+{
+	uint32_t i = 0;
+
+#ifdef PANLAW_USE_SSE2
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 halfPi = _mm_set1_ps((float)kPanLawHalfPi);
+
+	for (; i + 4 <= numSamples; i += 4)
+	{
+		__m128 x = _mm_mul_ps(half, _mm_add_ps(_mm_loadu_ps(pan + i), one));
+		x = _mm_min_ps(_mm_max_ps(x, zero), one);
+
+		__m128 left, right;
+		if (law == panLawType::kLinear)
+		{
+			left = _mm_sub_ps(one, x);
+			right = x;
+		}
+		else
+		{
+			__m128 theta = _mm_mul_ps(x, halfPi);
+			__m128 c = fastSinQuadrant(_mm_sub_ps(halfPi, theta));
+			__m128 s = fastSinQuadrant(theta);
+
+			if (law == panLawType::k4p5dB)
+			{
+				left = _mm_mul_ps(c, _mm_sqrt_ps(c));
+				right = _mm_mul_ps(s, _mm_sqrt_ps(s));
+			}
+			else if (law == panLawType::k6dB)
+			{
+				left = _mm_mul_ps(c, c);
+				right = _mm_mul_ps(s, s);
+			}
+			else
+			{
+				left = c;
+				right = s;
+			}
+		}
+		_mm_storeu_ps(gainL + i, left);
+		_mm_storeu_ps(gainR + i, right);
+	}
+#endif
+
+	// --- leftovers (or everything, without SSE2)
+	for (; i < numSamples; i++)
+		calculatePanGains(law, pan[i], gainL[i], gainR[i]);
+}
+
+#endif
@@ -4,11 +4,236 @@
 #define __SuperLFO__
 
 #include "fxobjects.h"
+#include <atomic>
 
-// --- LFO may have very diff waveforms from pitched output
-enum class LFOWaveform { kTriangle, kSin, kSaw, kRSH, kQRSH, kNoise, kQRNoise };
+// --- LFO may have very diff waveforms from pitched output; kUser plays a user loaded wavetable
+enum class LFOWaveform { kTriangle, kSin, kSaw, kRSH, kQRSH, kNoise, kQRNoise, kUser };
 enum class LFOMode { kSync, kOneShot, kFreeRun };
 
+/** which of the LFO outputs is used: normal, +90 degrees, inverted, -90 degrees */
+enum class LFOPhaseOutput { kNormal, kQuadPhase, kInverted, kQuadPhaseInverted };
+
+/** one of the SignalModulatorOutput fields, for rendering a single output with SuperLFO::renderBlock( ) */
+enum class ModOutputSelect { kNormal, kInverted, kQuadPhasePos, kQuadPhaseNeg,
+							 kUnipolarFromMax, kUnipolarFromMin, kQuadPhaseUnipolarFromMax, kQuadPhaseUnipolarFromMin };
+
+// --- sine approximation with parabolas
+const double kParabolicSineB = 4.0 / kPi;
+const double kParabolicSineC = -4.0 / (kPi* kPi);
+const double kParabolicSineP = 0.225;
+
+/**
+@parabolicSine
+\ingroup FX-Functions
+
+@brief sine approximation with parabolas; see http://devmaster.net/posts/9648/fast-and-accurate-sine-cosine
+
+\param angle -pi to +pi
+\return sin(angle), in the precision of the argument (float or double)
+*/
+template <typename T>
+inline T parabolicSine(T angle)
+{
+	T y = (T)kParabolicSineB * angle + (T)kParabolicSineC * angle * fabs(angle);
+	y = (T)kParabolicSineP * (y * fabs(y) - y) + y;
+	return y;
+}
+
+#define EXTRACT_BITS(the_val, bits_start, bits_len) ((the_val >> (bits_start - 1)) & ((1 << bits_len) - 1))
+
+// --- PN output scaling: 16 / 2^32, a power of two so multiplying gives exactly the old division
+const float kPNSequenceScale = 1.0f / 268435456.0f;
+
+/**
+@doPNSequence
+\ingroup FX-Functions
+
+@brief quasi-random noise generator; advances the 32-bit PN register one step
+
+\param uPNRegister the register (state)
+\return next PN value, -1.0 to +1.0
+*/
+inline double doPNSequence(uint32_t& uPNRegister)
+{
+	// --- get the bits
+	uint32_t b0 = EXTRACT_BITS(uPNRegister, 1, 1); // 1 = b0 is FIRST bit from right
+	uint32_t b1 = EXTRACT_BITS(uPNRegister, 2, 1); // 1 = b1 is SECOND bit from right
+	uint32_t b27 = EXTRACT_BITS(uPNRegister, 28, 1); // 28 = b27 is 28th bit from right
+	uint32_t b28 = EXTRACT_BITS(uPNRegister, 29, 1); // 29 = b28 is 29th bit from right
+
+	// --- form the XOR
+	uint32_t b31 = b0^b1^b27^b28;
+
+	// --- form the mask to OR with the register to load b31
+	if (b31 == 1)
+		b31 = 0x10000000;
+
+	// --- shift one bit to right
+	uPNRegister >>= 1;
+
+	// --- set the b31 bit
+	uPNRegister |= b31;
+
+	// --- convert the output into a floating point number, scaled by experimentation
+	// --- to a range of o to +2.0
+	float fOut = (float)(uPNRegister) * kPNSequenceScale;
+
+	// --- shift down to form a result from -1.0 to +1.0
+	fOut -= 1.0;
+
+	return fOut;
+}
+
+/**
+@doPNSequence
+\ingroup FX-Functions
+
+@brief run the quasi-random noise generator numSteps times; the feedback bit is OR'd into the
+       register, so the sequence is not linear and there is no closed-form jump; this is O(numSteps)
+
+\param uPNRegister the register (state)
+\param numSteps number of steps, must be at least 1
+\return the value of the last step, -1.0 to +1.0
+*/
+inline double doPNSequence(uint32_t& uPNRegister, uint64_t numSteps)
+{
+	for (uint64_t i = 1; i < numSteps; i++)
+		doPNSequence(uPNRegister);
+	return doPNSequence(uPNRegister);
+}
+
+// --- PCG32 LCG multiplier
+const uint64_t kLFORandomMultiplier = 6364136223846793005ULL;
+
+/**
+\class LFORandom
+\ingroup FX-Objects
+\brief
+Small, fast per-instance random number generator (PCG32: 64-bit LCG state with a permuted 32-bit output)
+for the LFO noise and sample/hold waveforms.
+
+Unlike rand( ) there is no shared global state, so LFOs on different threads neither contend nor
+interfere, and a given seed always gives the same sequence; with an explicit seed an offline render is
+reproducible. The generator can also be skipped ahead in O(log n), which keeps advance( ) and
+seekToSample( ) exact for the random waveforms.
+
+\author <Aaron Mutchler> <http://www.aaronmutchler.com>
+\remark see M.E. O'Neill, "PCG: A Family of Simple Fast Space-Efficient Statistically Good Algorithms for Random Number Generation"
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+class LFORandom
+{
+public:
+	LFORandom(void) { seed(0); }	/* C-TOR */
+
+	/** start a sequence; different streams give independent sequences for the same seed */
+	/**
+	\param _seed the seed
+	\param stream the stream (e.g. an LFO lane index)
+	*/
+	void seed(uint64_t _seed, uint64_t stream = 0)
+	{
+		state = 0;
+		increment = (stream << 1) | 1;
+		nextUInt32();
+		state += _seed;
+		nextUInt32();
+	}
+
+	/** next 32-bit value */
+	inline uint32_t nextUInt32()
+	{
+		uint64_t oldState = state;
+		state = oldState * kLFORandomMultiplier + increment;
+		uint32_t xorShifted = (uint32_t)(((oldState >> 18) ^ oldState) >> 27);
+		uint32_t rotation = (uint32_t)(oldState >> 59);
+		return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+	}
+
+	/** next value, -1.0 to +1.0 (same range as doWhiteNoise( )) */
+	inline double nextBipolar()
+	{
+		return (double)(int32_t)nextUInt32() * (1.0 / 2147483648.0);
+	}
+
+	/** fill a buffer with bipolar values */
+	/**
+	\param output the buffer
+	\param numSamples length of the buffer
+	*/
+	template <typename T>
+	void fill(T* output, uint32_t numSamples)
+	{
+		for (uint32_t i = 0; i < numSamples; i++)
+			output[i] = (T)nextBipolar();
+	}
+
+	/** skip numSteps values in O(log numSteps), as if nextUInt32( ) had been called numSteps times */
+	void discard(uint64_t numSteps)
+	{
+		// --- compose the LCG step with itself by squaring (Brown, "Random Number Generation with Arbitrary Stride")
+		uint64_t accMult = 1, accPlus = 0;
+		uint64_t curMult = kLFORandomMultiplier, curPlus = increment;
+		while (numSteps > 0)
+		{
+			if (numSteps & 1)
+			{
+				accMult *= curMult;
+				accPlus = accPlus * curMult + curPlus;
+			}
+			curPlus = (curMult + 1) * curPlus;
+			curMult *= curMult;
+			numSteps >>= 1;
+		}
+		state = accMult * state + accPlus;
+	}
+
+private:
+	uint64_t state = 0;		///< LCG state
+	uint64_t increment = 1;	///< LCG increment (odd), selects the stream
+};
+
+/**
+@getLFORandomSeed
+\ingroup FX-Functions
+
+@brief a seed for LFOs that were not given one; mixes the time with a running count so that
+       instances reset in the same second still get different sequences
+
+\return the seed
+*/
+inline uint64_t getLFORandomSeed()
+{
+	static std::atomic<uint64_t> instanceCount(0);
+	uint64_t seed = ((uint64_t)time(NULL) << 20) ^ (++instanceCount * 0x9E3779B97F4A7C15ULL);
+	return seed;
+}
+
+/**
+@getRandomSHHolds
+\ingroup FX-Functions
+
+@brief number of new random sample/hold values that skipping numSamples sample periods produces; the
+       per-sample logic is: if (counter > hold) { counter -= hold; new value; } counter += 1;
+
+\param counter the sample/hold counter (1 or more, i.e. after the first sample); returned advanced
+\param hold the hold time in samples (1 or more)
+\param numSamples number of sample periods to skip
+\return number of new values
+*/
+inline uint64_t getRandomSHHolds(double& counter, double hold, uint64_t numSamples)
+{
+	// --- the counter never ends a sample period above hold + 1
+	double newCounter = counter + (double)numSamples;
+	double holds = ceil((newCounter - (hold + 1.0)) / hold);
+	if (holds < 0.0) holds = 0.0;
+
+	counter = newCounter - holds*hold;
+	return (uint64_t)holds;
+}
+
+
 /**
 \struct SuperLFOParameters
 \ingroup FX-Objects
@@ -52,20 +277,146 @@ struct SuperLFOParameters
 	double outputAmplitude = 1.0;
 };
 
+/** the outputs of a signal modulator, in the modulator's sample type */
+template <typename T = double>
 struct SignalModulatorOutput
 {
 	SignalModulatorOutput() {}
 
-	double normalOutput = 0.0;			///< normal
-	double invertedOutput = 0.0;		///< inverted
-	double quadPhaseOutput_pos = 0.0;	///< 90 degrees out
-	double quadPhaseOutput_neg = 0.0;	///< -90 degrees out
-	double unipolarOutputFromMax = 1.0;	///< top down modulation
-	double unipolarOutputFromMin = 0.0;	///< bottom up modulation
-	double quadPhaseUnipolarOutputFromMax = 1.0;	///< top down modulation
-	double quadPhaseUnipolarOutputFromMin = 0.0;	///< bottom up modulation
+	T normalOutput = (T)0.0;			///< normal
+	T invertedOutput = (T)0.0;			///< inverted
+	T quadPhaseOutput_pos = (T)0.0;		///< 90 degrees out
+	T quadPhaseOutput_neg = (T)0.0;		///< -90 degrees out
+	T unipolarOutputFromMax = (T)1.0;	///< top down modulation
+	T unipolarOutputFromMin = (T)0.0;	///< bottom up modulation
+	T quadPhaseUnipolarOutputFromMax = (T)1.0;	///< top down modulation
+	T quadPhaseUnipolarOutputFromMin = (T)0.0;	///< bottom up modulation
 };
 
+// --- length of the built in LFO wavetables; linear interpolation of the sine is good to 1.2e-6 (-118 dB)
+const uint32_t kLFOWavetableLength = 2048;
+
+/**
+\class LFOWavetable
+\ingroup FX-Objects
+\brief
+The LFOWavetable object holds one cycle of an LFO waveform and reads it at a fractional phase with
+linear interpolation.
+
+The table is stored with one extra point at the end (the value the cycle heads for as the phase
+reaches 1.0) so a read never has to wrap its index; for a continuous shape that is the first point
+again, for a saw it is the top of the ramp.
+
+Fill tables off the audio thread; reading is lock free and allocation free.
+
+\author <Aaron Mutchler> <http://www.aaronmutchler.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+class LFOWavetable
+{
+public:
+	LFOWavetable(void) {}	/* C-TOR */
+	~LFOWavetable(void) {}	/* D-TOR */
+
+	/** load one cycle of a continuous shape; the point after the last is the first */
+	/**
+	\param cycle the samples of one cycle, phase 0.0 to just short of 1.0
+	\param length number of samples, at least 1
+	*/
+	void setTable(const double* cycle, uint32_t length)
+	{
+		if (!cycle || length == 0) return;
+		setTable(cycle, length, cycle[0]);
+	}
+
+	/** load one cycle plus the value at the very end of the cycle (for shapes that jump at the wrap) */
+	/**
+	\param cycle the samples of one cycle, phase 0.0 to just short of 1.0
+	\param length number of samples, at least 1
+	\param endValue the value approached as the phase reaches 1.0
+	*/
+	void setTable(const double* cycle, uint32_t length, double endValue)
+	{
+		if (!cycle || length == 0) return;
+		table.assign(cycle, cycle + length);
+		table.push_back(endValue);
+		tableLength = length;
+	}
+
+	/** number of samples in the cycle (0 when empty) */
+	uint32_t getLength() const { return tableLength; }
+
+	/** read the table */
+	/**
+	\param phase 0.0 to 1.0
+	\return the interpolated table value
+	*/
+	inline double readTable(double phase) const
+	{
+		double index = phase * tableLength;
+		uint32_t i = (uint32_t)index;
+		double frac = index - i;
+
+		// --- phase 1.0 (negative frequencies wrap to it) reads the end point
+		if (i >= tableLength) { i = tableLength - 1; frac = 1.0; }
+
+		return table[i] + frac*(table[i + 1] - table[i]);
+	}
+
+protected:
+	std::vector<double> table;	///< the cycle plus the end point
+	uint32_t tableLength = 0;	///< samples in the cycle
+};
+
+/**
+\struct LFOWavetables
+\ingroup FX-Objects
+\brief
+The built in LFO shapes, created once and shared by every SuperLFO; see getLFOWavetables( )
+*/
+struct LFOWavetables
+{
+	LFOWavetables()
+	{
+		std::vector<double> cycle(kLFOWavetableLength);
+
+		for (uint32_t i = 0; i < kLFOWavetableLength; i++)
+			cycle[i] = sin(kTwoPi*i / kLFOWavetableLength);
+		sine.setTable(&cycle[0], kLFOWavetableLength);
+
+		// --- triangle is 1 at the ends and -1 in the middle, as the original 2|saw| - 1
+		for (uint32_t i = 0; i < kLFOWavetableLength; i++)
+			cycle[i] = 2.0*fabs(2.0*i / kLFOWavetableLength - 1.0) - 1.0;
+		triangle.setTable(&cycle[0], kLFOWavetableLength);
+
+		// --- saw ramps -1 to +1 and jumps back at the wrap
+		for (uint32_t i = 0; i < kLFOWavetableLength; i++)
+			cycle[i] = 2.0*i / kLFOWavetableLength - 1.0;
+		saw.setTable(&cycle[0], kLFOWavetableLength, 1.0);
+	}
+
+	LFOWavetable sine;		///< sin(2*pi*phase)
+	LFOWavetable triangle;	///< 2|2*phase - 1| - 1
+	LFOWavetable saw;		///< 2*phase - 1
+};
+
+/**
+@getLFOWavetables
+\ingroup FX-Functions
+
+@brief the shared built in LFO wavetables; built on first use (thread safe), so call it once before
+       audio starts (constructing a SuperLFO does)
+
+\return the tables
+*/
+inline const LFOWavetables& getLFOWavetables()
+{
+	static const LFOWavetables tables;
+	return tables;
+}
+
 /**
 \class IAudioSignalGenerator
 \ingroup Interfaces
@@ -80,6 +431,7 @@ Outpput I/F:
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
+template <typename T = double>
 class IAudioSignalModualtor
 {
 public:
@@ -91,7 +443,7 @@ public:
 	virtual bool reset(double _sampleRate) = 0;
 
 	/** render the generator output */
-	virtual const SignalModulatorOutput renderModulatorOutput() = 0;
+	virtual const SignalModulatorOutput<T> renderModulatorOutput() = 0;
 };
 
 /**
@@ -107,15 +459,31 @@ Audio I/O:
 Control I/F:
 - Use SuperLFOParameters structure to get/set object params.
 
+Sample type:
+- T is the type of the outputs, SuperLFO<float> for single precision DSP; the timebase
+  (modulo counters, phase increment, hold counter) is always double so long runs do not drift.
+
+Waveforms:
+- sine, triangle and saw are read from the shared wavetables (getLFOWavetables( )) and kUser from a
+  table set with setUserWavetable( ); the quad phase output is the same table read 90 degrees on,
+  so every periodic shape costs two table reads per sample.
+- the random shapes (RSH, QRSH, noise) are generated.
+
+Dispatch:
+- waveform and mode are template parameters of renderShape( ); setParameters( ) (and anything that
+  changes the one-shot state) picks the specialization once, so renderModulatorOutput( ) is a single
+  switch jump into straight-line code instead of a mode test and a waveform if/else chain.
+
 \author <Your Name> <http://www.yourwebsite.com>
 \remark <Put any remarks or notes here>
 \version Revision : 1.0
 \date Date : 2019 / 01 / 31
 */
-class SuperLFO : public IAudioSignalModualtor
+template <typename T = double>
+class SuperLFO : public IAudioSignalModualtor<T>
 {
 public:
-	SuperLFO(void) {}	/* C-TOR */
+	SuperLFO(void) { selectRenderShape(); }	/* C-TOR */
 	~SuperLFO(void) {}	/* D-TOR */
 
 public:
@@ -125,10 +493,13 @@ public:
 		// --- do any other per-audio-run inits here
 		sampleRate = _sampleRate;
 
-		srand(time(NULL)); // --- seed random number generator
+		// --- seed the random number generator; an explicit seed replays the same sequence every reset
+		random.seed(useRandomSeed ? randomSeed : getLFORandomSeed());
 
-		// --- randomize the PN register
-		pnRegister = rand();
+		// --- randomize the PN register (an all-zero register would stick at zero)
+		pnRegister = random.nextUInt32() | 1;
+		pnSeed = pnRegister;
+		randomAtReset = random;
 
 		// --- calculate modulo counter phase incrementer
 		phaseInc = parameters.frequency_Hz / sampleRate;
@@ -136,92 +507,418 @@ public:
 		// --- timebase variables
 		modCounter = 0.0;			///< modulo counter [0.0, +1.0]
 		modCounterQP = 0.25;		///<Quad Phase modulo counter [0.0, +1.0]
+		renderComplete = false;
+		randomSHCounter = -1.0;
+		selectRenderShape();
 
 		return true;
 	}
 
-	/** process MONO input */
+	/** set the seed used by every following reset( ), so that the noise and sample/hold waveforms
+	    give the same sequence each time (e.g. for reproducible offline renders) */
 	/**
-	\param xn input
-	\return the processed sample
+	\param seed the seed
 	*/
-	virtual const SignalModulatorOutput renderModulatorOutput()
+	void setRandomSeed(uint64_t seed)
+	{
+		randomSeed = seed;
+		useRandomSeed = true;
+	}
+
+	/** go back to a different random sequence on every reset( ) (the default) */
+	void clearRandomSeed() { useRandomSeed = false; }
+
+	/** move the LFO numSamples sample periods ahead without rendering, exactly as if renderModulatorOutput( )
+	    had been called numSamples times; O(1) except for the quasi-random shapes, which step their PN
+	    register once per value they would have drawn */
+	/**
+	\param numSamples number of sample periods to skip
+	*/
+	void advance(uint64_t numSamples)
+	{
+		if (numSamples == 0 || renderComplete)
+			return;
+
+		// --- the first render of a random sample/hold run draws the first value; do that one for real
+		bool isSH = parameters.waveform == LFOWaveform::kRSH || parameters.waveform == LFOWaveform::kQRSH;
+		if (isSH && randomSHCounter < 0.0)
+		{
+			renderModulatorOutput();
+			if (--numSamples == 0 || renderComplete)
+				return;
+		}
+
+		// --- timebase: a one-shot finishes if a render during the skip would have seen the wrap
+		double mod = modCounter + phaseInc*(double)numSamples;
+		if (parameters.mode == LFOMode::kOneShot)
+		{
+			double lastStart = modCounter + phaseInc*(double)(numSamples - 1);
+			if ((phaseInc > 0 && lastStart >= 1.0) || (phaseInc < 0 && lastStart <= 0.0))
+			{
+				renderComplete = true;
+				selectRenderShape();
+				return;
+			}
+			modCounter = mod;
+		}
+		else
+			modCounter = mod - floor(mod);
+
+		// --- the noise shapes draw two values (normal and quad phase) per sample
+		if (parameters.waveform == LFOWaveform::kNoise)
+			random.discard(2 * numSamples);
+		else if (parameters.waveform == LFOWaveform::kQRNoise)
+			doPNSequence(pnRegister, 2 * numSamples);
+
+		if (!isSH)
+			return;
+
+		// --- random sample and hold; a hold shorter than a sample means a new value every sample
+		double hold = parameters.frequency_Hz > 0.0 ? sampleRate / parameters.frequency_Hz : 0.0;
+		uint64_t holds = numSamples;
+		if (hold >= 1.0)
+			holds = getRandomSHHolds(randomSHCounter, hold, numSamples);
+
+		if (holds > 0)
+		{
+			if (parameters.waveform == LFOWaveform::kRSH)
+			{
+				random.discard(holds - 1);
+				randomSHValue = (T)random.nextBipolar();
+			}
+			else
+				randomSHValue = (T)doPNSequence(pnRegister, holds);
+		}
+	}
+
+	/** put the LFO where it would be at absoluteIndex samples after its last reset( ), assuming the
+	    current parameters held the whole time; e.g. after a transport jump */
+	/**
+	\param absoluteIndex sample index, 0 = the first sample after reset( )
+	*/
+	void seekToSample(uint64_t absoluteIndex)
+	{
+		// --- back to the reset state, keeping the random state so the random shapes replay the same sequence
+		modCounter = 0.0;
+		modCounterQP = 0.25;
+		renderComplete = false;
+		randomSHCounter = -1.0;
+		randomSHValue = (T)0.0;
+		pnRegister = pnSeed;
+		random = randomAtReset;
+		selectRenderShape();
+
+		advance(absoluteIndex);
+	}
+
+	/** render one sample period of every output */
+	/**
+	\return the LFO outputs
+	*/
+	virtual const SignalModulatorOutput<T> renderModulatorOutput()
 	{
 		// --- setup for output
-		SignalModulatorOutput lfoOutputData; // should auto-zero on instantiation
+		SignalModulatorOutput<T> lfoOutputData; // should auto-zero on instantiation
 
-		if (renderComplete)
+		// --- the common case, a free running table shape, is tested first; everything else is one
+		//     jump to the specialization picked by selectRenderShape( )
+		if (renderIndex == 2 * kTableShape)
 		{
+			renderShape<kTableShape, false>(lfoOutputData);
 			return lfoOutputData;
 		}
 
-		// --- always first!
-		bool bWrapped = checkAndWrapModulo(modCounter, phaseInc);
-		if (bWrapped && parameters.mode == LFOMode::kOneShot)
+		switch (renderIndex)
 		{
-			renderComplete = true;
-			return lfoOutputData;
+			case 1: renderShape<kTableShape, true>(lfoOutputData); break;
+			case 2: renderShape<kNoiseShape, false>(lfoOutputData); break;
+			case 3: renderShape<kNoiseShape, true>(lfoOutputData); break;
+			case 4: renderShape<kQRNoiseShape, false>(lfoOutputData); break;
+			case 5: renderShape<kQRNoiseShape, true>(lfoOutputData); break;
+			case 6: renderShape<kRSHShape, false>(lfoOutputData); break;
+			case 7: renderShape<kRSHShape, true>(lfoOutputData); break;
+			case 8: renderShape<kQRSHShape, false>(lfoOutputData); break;
+			case 9: renderShape<kQRSHShape, true>(lfoOutputData); break;
+			case 10: renderShape<kNoShape, false>(lfoOutputData); break;
+			case 11: renderShape<kNoShape, true>(lfoOutputData); break;
+			default: break; // --- one-shot finished: reset values
 		}
+		return lfoOutputData;
+	}
 
-		// --- QP output always follows location of current modulo; first set equal
-		modCounterQP = modCounter;
+	/** render one of the outputs for a block of sample periods; only the requested output is computed,
+	    and the waveform and mode are dispatched once for the block */
+	/**
+	\param out array to write
+	\param numSamples number of sample periods to render
+	\param which the output to render
+	*/
+	void renderBlock(T* out, uint32_t numSamples, ModOutputSelect which)
+	{
+		bool quad = which == ModOutputSelect::kQuadPhasePos || which == ModOutputSelect::kQuadPhaseNeg ||
+					which == ModOutputSelect::kQuadPhaseUnipolarFromMax || which == ModOutputSelect::kQuadPhaseUnipolarFromMin;
 
-		// --- then, advance modulo by quadPhaseInc = 0.25 = 90 degrees, AND wrap if needed
-		advanceAndCheckWrapModulo(modCounterQP, 0.25);
+		// --- raw waveform values; a one-shot that finishes part way stops early
+		uint32_t rendered = 0;
+		switch (renderIndex)
+		{
+			case 0: rendered = renderShapeBlock<kTableShape, false>(out, numSamples, quad); break;
+			case 1: rendered = renderShapeBlock<kTableShape, true>(out, numSamples, quad); break;
+			case 2: rendered = renderShapeBlock<kNoiseShape, false>(out, numSamples, quad); break;
+			case 3: rendered = renderShapeBlock<kNoiseShape, true>(out, numSamples, quad); break;
+			case 4: rendered = renderShapeBlock<kQRNoiseShape, false>(out, numSamples, quad); break;
+			case 5: rendered = renderShapeBlock<kQRNoiseShape, true>(out, numSamples, quad); break;
+			case 6: rendered = renderShapeBlock<kRSHShape, false>(out, numSamples, quad); break;
+			case 7: rendered = renderShapeBlock<kRSHShape, true>(out, numSamples, quad); break;
+			case 8: rendered = renderShapeBlock<kQRSHShape, false>(out, numSamples, quad); break;
+			case 9: rendered = renderShapeBlock<kQRSHShape, true>(out, numSamples, quad); break;
+			case 10: rendered = renderShapeBlock<kNoShape, false>(out, numSamples, quad); break;
+			case 11: rendered = renderShapeBlock<kNoShape, true>(out, numSamples, quad); break;
+			default: break; // --- one-shot finished
+		}
 
-		// --- calculate the oscillator value
-		if (parameters.waveform == LFOWaveform::kSin)
+		// --- every output is a scaled and offset copy of the raw value: amplitude, then for the inverted
+		//     outputs a sign flip, for the unipolar ones bipolarToUnipolar( ) plus the peak/trough shift
+		T amplitude = (T)parameters.outputAmplitude;
+		T scale = (T)1.0;
+		T offset = (T)0.0;
+		T finishedValue = (T)0.0;
+		if (which == ModOutputSelect::kInverted || which == ModOutputSelect::kQuadPhaseNeg)
+			scale = (T)-1.0;
+		else if (which == ModOutputSelect::kUnipolarFromMax || which == ModOutputSelect::kQuadPhaseUnipolarFromMax)
+		{
+			scale = (T)0.5;
+			offset = (T)(0.5 + (1.0 - 0.5 - (parameters.outputAmplitude / 2.0)));
+			finishedValue = (T)1.0;
+		}
+		else if (which == ModOutputSelect::kUnipolarFromMin || which == ModOutputSelect::kQuadPhaseUnipolarFromMin)
 		{
-			// --- calculate normal angle
-			double angle = modCounter*2.0*kPi - kPi;
+			scale = (T)0.5;
+			offset = (T)(0.5 - (1.0 - 0.5 - (parameters.outputAmplitude / 2.0)));
+		}
 
-			// --- norm output with parabolicSine approximation
-			lfoOutputData.normalOutput = parabolicSine(-angle);
+		for (uint32_t i = 0; i < rendered; i++)
+			out[i] = (out[i] * amplitude) * scale + offset;
+
+		// --- a finished one-shot outputs the reset values, as renderModulatorOutput( ) does
+		for (uint32_t i = rendered; i < numSamples; i++)
+			out[i] = finishedValue;
+	}
 
-			// --- calculate QP angle
-			angle = modCounterQP*2.0*kPi - kPi;
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return SuperLFOParameters custom data structure
+	*/
+	SuperLFOParameters getParameters()
+	{
+		return parameters;
+	}
 
-			// --- calc QP output
-			lfoOutputData.quadPhaseOutput_pos = parabolicSine(-angle);
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param SuperLFOParameters custom data structure
+	*/
+	void setParameters(const SuperLFOParameters& params)
+	{
+		// --- copy them; note you may choose to ignore certain items
+		//     and copy the variables one at a time, or you may test
+		//     to see if cook-able variables have changed; if not, then
+		//     do not re-cook them as it just wastes CPU
+		parameters = params;
+
+		// --- cook parameters here
+		phaseInc = parameters.frequency_Hz / sampleRate;
+		selectRenderShape();
+	}
+
+	/** set the table played by LFOWaveform::kUser; the caller owns it and must keep it alive (and unchanged)
+	    while this LFO can use it; nullptr silences kUser */
+	/**
+	\param table one cycle of the user shape
+	*/
+	void setUserWavetable(const LFOWavetable* table)
+	{
+		userWavetable = table;
+		selectRenderShape();
+	}
+
+	/** change the rate the LFO is rendered at without resetting its phase, e.g. to run it at a control rate */
+	/**
+	\param _sampleRate the rate at which renderModulatorOutput( ) will be called
+	*/
+	void setSampleRate(double _sampleRate)
+	{
+		sampleRate = _sampleRate;
+		phaseInc = parameters.frequency_Hz / sampleRate;
+	}
+
+private:
+	SuperLFOParameters parameters; ///< object parameters
+
+	// --- local variables used by this object
+	double sampleRate = 0.0;	///< sample rate
+								
+	// --- timebase variables
+	double modCounter = 0.0;			///< modulo counter [0.0, +1.0]
+	double phaseInc = 0.0;				///< phase inc = fo/fs
+	double modCounterQP = 0.25;			///< Quad Phase modulo counter [0.0, +1.0]
+	bool renderComplete = false;		///< flag for one-shot
+
+	// --- 32-bit register for RS&H
+	uint32_t pnRegister = 0;			///< 32 bit register for PN oscillator
+	uint32_t pnSeed = 0;				///< PN register value at reset, for seekToSample( )
+	LFORandom random;					///< white noise and random sample/hold generator
+	LFORandom randomAtReset;			///< generator state at reset, for seekToSample( )
+	uint64_t randomSeed = 0;			///< explicit seed, see setRandomSeed( )
+	bool useRandomSeed = false;			///< true if reset( ) uses randomSeed
+	double randomSHCounter = -1.0;		///< random sample/hold counter;  -1 is reset condition
+	T randomSHValue = (T)0.0;			///< current output, needed because we hold this output for some number of samples = (sampleRate / oscFrequency)
+
+	// --- wavetables
+	const LFOWavetable* wavetable = nullptr;		///< table for the current waveform; nullptr for the random shapes
+	const LFOWavetable* userWavetable = nullptr;	///< table for LFOWaveform::kUser
+
+	// --- the render specializations
+	enum { kTableShape, kNoiseShape, kQRNoiseShape, kRSHShape, kQRSHShape, kNoShape, kNumShapes };
+	uint32_t renderIndex = 2 * kNumShapes;	///< the renderShape( ) specialization, shape * 2 + oneShot; 2 * kNumShapes = finished
+
+	/** pick the wavetable and the renderShape( ) specialization for the current waveform, mode and one-shot state */
+	void selectRenderShape()
+	{
+		const LFOWavetables& tables = getLFOWavetables();
+		uint32_t shape = kNoShape;
+		wavetable = nullptr;
+		switch (parameters.waveform)
+		{
+			case LFOWaveform::kSin: wavetable = &tables.sine; shape = kTableShape; break;
+			case LFOWaveform::kTriangle: wavetable = &tables.triangle; shape = kTableShape; break;
+			case LFOWaveform::kSaw: wavetable = &tables.saw; shape = kTableShape; break;
+			case LFOWaveform::kUser:
+				if (userWavetable && userWavetable->getLength() > 0) { wavetable = userWavetable; shape = kTableShape; }
+				break;
+			case LFOWaveform::kNoise: shape = kNoiseShape; break;
+			case LFOWaveform::kQRNoise: shape = kQRNoiseShape; break;
+			case LFOWaveform::kRSH: shape = kRSHShape; break;
+			case LFOWaveform::kQRSH: shape = kQRSHShape; break;
 		}
-		else if (parameters.waveform == LFOWaveform::kTriangle)
+
+		uint32_t oneShot = parameters.mode == LFOMode::kOneShot ? 1 : 0;
+		renderIndex = renderComplete ? 2 * kNumShapes : 2 * shape + oneShot;
+	}
+
+	/** render the raw (bipolar, unscaled) normal or quad phase value of one waveform class for a block; same
+	    timebase and random state as renderShape( ), but only one output and no per-sample dispatch */
+	/**
+	\return the number of samples rendered; less than numSamples if a one-shot finished
+	*/
+	template <uint32_t shape, bool oneShot>
+	uint32_t renderShapeBlock(T* out, uint32_t numSamples, bool quad)
+	{
+		double hold = sampleRate / parameters.frequency_Hz;
+
+		for (uint32_t i = 0; i < numSamples; i++)
 		{
-			// --- triv saw
-			lfoOutputData.normalOutput = unipolarToBipolar(modCounter);
+			// --- always first!
+			bool bWrapped = checkAndWrapModulo(modCounter, phaseInc);
+			if (oneShot && bWrapped)
+			{
+				renderComplete = true;
+				selectRenderShape();
+				return i;
+			}
 
-			// --- bipolar triagle
-			lfoOutputData.normalOutput = 2.0*fabs(lfoOutputData.normalOutput) - 1.0;
+			T value = (T)0.0;
+			if (shape == kTableShape)
+			{
+				// --- as renderShape( ): the normal phase is read as is (it may be 1.0), the quad phase wrapped
+				double phase = modCounter;
+				if (quad)
+				{
+					phase += 0.25;
+					phase -= (phase >= 1.0) ? 1.0 : 0.0;
+				}
+				value = (T)wavetable->readTable(phase);
+			}
+			else if (shape == kNoiseShape)
+			{
+				// --- as renderShape( ): one value each for the normal and quad outputs, to keep the sequence
+				T normal = (T)random.nextBipolar();
+				T quadPhase = (T)random.nextBipolar();
+				value = quad ? quadPhase : normal;
+			}
+			else if (shape == kQRNoiseShape)
+			{
+				// --- the normal and quad outputs are successive PN values; step both to keep the sequence
+				T normal = (T)doPNSequence(pnRegister);
+				T quadPhase = (T)doPNSequence(pnRegister);
+				value = quad ? quadPhase : normal;
+			}
+			else if (shape == kRSHShape || shape == kQRSHShape)
+			{
+				if (randomSHCounter < 0)
+				{
+					randomSHValue = (T)(shape == kRSHShape ? random.nextBipolar() : doPNSequence(pnRegister));
+					randomSHCounter = 1.0;
+				}
+				else if (randomSHCounter > hold)
+				{
+					randomSHCounter -= hold;
+					randomSHValue = (T)(shape == kRSHShape ? random.nextBipolar() : doPNSequence(pnRegister));
+				}
+				randomSHCounter += 1.0;
+				value = randomSHValue;
+			}
+			out[i] = value;
 
-			// -- quad phase
-			lfoOutputData.quadPhaseOutput_pos = unipolarToBipolar(modCounterQP);
+			// --- setup for next sample period
+			advanceModulo(modCounter, phaseInc);
+		}
+		return numSamples;
+	}
 
-			// bipolar triagle
-			lfoOutputData.quadPhaseOutput_pos = 2.0*fabs(lfoOutputData.quadPhaseOutput_pos) - 1.0;
+	/** render one sample period of one waveform class in one mode; the shape and oneShot tests
+	    are on template parameters, so each specialization compiles to straight-line code */
+	template <uint32_t shape, bool oneShot>
+	void renderShape(SignalModulatorOutput<T>& lfoOutputData)
+	{
+		// --- always first!
+		bool bWrapped = checkAndWrapModulo(modCounter, phaseInc);
+		if (oneShot && bWrapped)
+		{
+			renderComplete = true;
+			selectRenderShape();
+			return;
 		}
-		else if (parameters.waveform == LFOWaveform::kSaw)
+
+		// --- QP output always follows location of current modulo; first set equal
+		modCounterQP = modCounter;
+
+		// --- then, advance modulo by quadPhaseInc = 0.25 = 90 degrees, AND wrap if needed
+		advanceAndCheckWrapModulo(modCounterQP, 0.25);
+
+		// --- calculate the oscillator value
+		if (shape == kTableShape)
 		{
-			lfoOutputData.normalOutput = unipolarToBipolar(modCounter);
-			lfoOutputData.quadPhaseOutput_pos = unipolarToBipolar(modCounterQP);
+			// --- periodic shapes: one table, read at the normal and quad phase
+			lfoOutputData.normalOutput = (T)wavetable->readTable(modCounter);
+			lfoOutputData.quadPhaseOutput_pos = (T)wavetable->readTable(modCounterQP);
 		}
-		else if (parameters.waveform == LFOWaveform::kNoise)
+		else if (shape == kNoiseShape)
 		{
-			lfoOutputData.normalOutput = doWhiteNoise();
-			lfoOutputData.quadPhaseOutput_pos = doWhiteNoise();
+			lfoOutputData.normalOutput = (T)random.nextBipolar();
+			lfoOutputData.quadPhaseOutput_pos = (T)random.nextBipolar();
 		}
-		else if (parameters.waveform == LFOWaveform::kQRNoise)
+		else if (shape == kQRNoiseShape)
 		{
-			lfoOutputData.normalOutput = doPNSequence(pnRegister);
-			lfoOutputData.quadPhaseOutput_pos = doPNSequence(pnRegister);
+			lfoOutputData.normalOutput = (T)doPNSequence(pnRegister);
+			lfoOutputData.quadPhaseOutput_pos = (T)doPNSequence(pnRegister);
 		}
-		else if (parameters.waveform == LFOWaveform::kRSH || parameters.waveform == LFOWaveform::kQRSH)
+		else if (shape == kRSHShape || shape == kQRSHShape)
 		{
 			// --- is this is the very first run? if so, form first output sample
 			if (randomSHCounter < 0)
 			{
-				if (parameters.waveform == LFOWaveform::kRSH)
-					randomSHValue = doWhiteNoise();
-				else
-					randomSHValue = doPNSequence(pnRegister);
+				randomSHValue = (T)(shape == kRSHShape ? random.nextBipolar() : doPNSequence(pnRegister));
 
 				// --- init the sample counter, will be advanced below
 				randomSHCounter = 1.0;
@@ -232,10 +929,7 @@ public:
 				// --- wrap counter
 				randomSHCounter -= sampleRate / parameters.frequency_Hz;
 
-				if (parameters.waveform == LFOWaveform::kRSH)
-					randomSHValue = doWhiteNoise();
-				else
-					randomSHValue = doPNSequence(pnRegister);
+				randomSHValue = (T)(shape == kRSHShape ? random.nextBipolar() : doPNSequence(pnRegister));
 			}
 
 			// --- advance the sample counter
@@ -246,8 +940,9 @@ public:
 		}
 
 		// --- scale by amplitude
-		lfoOutputData.normalOutput *= parameters.outputAmplitude;
-		lfoOutputData.quadPhaseOutput_pos *= parameters.outputAmplitude;
+		T amplitude = (T)parameters.outputAmplitude;
+		lfoOutputData.normalOutput *= amplitude;
+		lfoOutputData.quadPhaseOutput_pos *= amplitude;
 
 		// --- invert two main outputs to make the opposite versions, scaling carries over
 		lfoOutputData.invertedOutput = -lfoOutputData.normalOutput;
@@ -256,70 +951,25 @@ public:
 		// --- special unipolar from max output for tremolo
 		//
 		// --- first, convert to unipolar
-		lfoOutputData.unipolarOutputFromMax = bipolarToUnipolar(lfoOutputData.normalOutput);
-		lfoOutputData.unipolarOutputFromMin = bipolarToUnipolar(lfoOutputData.normalOutput);
-		lfoOutputData.quadPhaseUnipolarOutputFromMax = bipolarToUnipolar(lfoOutputData.quadPhaseOutput_pos);
-		lfoOutputData.quadPhaseUnipolarOutputFromMin = bipolarToUnipolar(lfoOutputData.quadPhaseOutput_pos);
+		lfoOutputData.unipolarOutputFromMax = (T)bipolarToUnipolar(lfoOutputData.normalOutput);
+		lfoOutputData.unipolarOutputFromMin = (T)bipolarToUnipolar(lfoOutputData.normalOutput);
+		lfoOutputData.quadPhaseUnipolarOutputFromMax = (T)bipolarToUnipolar(lfoOutputData.quadPhaseOutput_pos);
+		lfoOutputData.quadPhaseUnipolarOutputFromMin = (T)bipolarToUnipolar(lfoOutputData.quadPhaseOutput_pos);
 
 		// --- then shift upwards by enough to put peaks right at 1.0
 		//     NOTE: leaving the 0.5 in the equation - it is the unipolar offset when convering bipolar; but it could be changed...
-		lfoOutputData.unipolarOutputFromMax = lfoOutputData.unipolarOutputFromMax + (1.0 - 0.5 - (parameters.outputAmplitude / 2.0));
-		lfoOutputData.quadPhaseUnipolarOutputFromMax = lfoOutputData.quadPhaseUnipolarOutputFromMax + (1.0 - 0.5 - (parameters.outputAmplitude / 2.0));
+		T unipolarShift = (T)(1.0 - 0.5 - (parameters.outputAmplitude / 2.0));
+		lfoOutputData.unipolarOutputFromMax = lfoOutputData.unipolarOutputFromMax + unipolarShift;
+		lfoOutputData.quadPhaseUnipolarOutputFromMax = lfoOutputData.quadPhaseUnipolarOutputFromMax + unipolarShift;
 
 		// --- then shift down enough to put troughs at 0.0
-		lfoOutputData.unipolarOutputFromMin = lfoOutputData.unipolarOutputFromMin - (1.0 - 0.5 - (parameters.outputAmplitude / 2.0));
-		lfoOutputData.quadPhaseUnipolarOutputFromMin = lfoOutputData.quadPhaseUnipolarOutputFromMin - (1.0 - 0.5 - (parameters.outputAmplitude / 2.0));
+		lfoOutputData.unipolarOutputFromMin = lfoOutputData.unipolarOutputFromMin - unipolarShift;
+		lfoOutputData.quadPhaseUnipolarOutputFromMin = lfoOutputData.quadPhaseUnipolarOutputFromMin - unipolarShift;
 
 		// --- setup for next sample period
 		advanceModulo(modCounter, phaseInc);
-
-		// --- scale by amplituded
-		return lfoOutputData;
-	}
-
-
-	/** get parameters: note use of custom structure for passing param data */
-	/**
-	\return SuperLFOParameters custom data structure
-	*/
-	SuperLFOParameters getParameters()
-	{
-		return parameters;
-	}
-
-	/** set parameters: note use of custom structure for passing param data */
-	/**
-	\param SuperLFOParameters custom data structure
-	*/
-	void setParameters(const SuperLFOParameters& params)
-	{
-		// --- copy them; note you may choose to ignore certain items
-		//     and copy the variables one at a time, or you may test
-		//     to see if cook-able variables have changed; if not, then
-		//     do not re-cook them as it just wastes CPU
-		parameters = params;
-
-		// --- cook parameters here
-		phaseInc = parameters.frequency_Hz / sampleRate;
 	}
 
-private:
-	SuperLFOParameters parameters; ///< object parameters
-
-	// --- local variables used by this object
-	double sampleRate = 0.0;	///< sample rate
-								
-	// --- timebase variables
-	double modCounter = 0.0;			///< modulo counter [0.0, +1.0]
-	double phaseInc = 0.0;				///< phase inc = fo/fs
-	double modCounterQP = 0.25;			///< Quad Phase modulo counter [0.0, +1.0]
-	bool renderComplete = false;		///< flag for one-shot
-
-	// --- 32-bit register for RS&H
-	uint32_t pnRegister = 0;			///< 32 bit register for PN oscillator
-	int randomSHCounter = -1;			///< random sample/hold counter;  -1 is reset condition
-	double randomSHValue = 0.0;			///< current output, needed because we hold this output for some number of samples = (sampleRate / oscFrequency)
-
 	/**
 	\struct checkAndWrapModulo
 	\brief Check a modulo counter and wrap it if necessary
@@ -371,53 +1021,509 @@ private:
 
 	// --- increment the modulo counter
 	inline void advanceModulo(double& moduloCounter, double phaseInc) { moduloCounter += phaseInc; }
+};
 
-	// --- sine approximation with parabolas
-	const double B = 4.0 / kPi;
-	const double C = -4.0 / (kPi* kPi);
-	const double P = 0.225;
-	// http://devmaster.net/posts/9648/fast-and-accurate-sine-cosine
-	//
-	// --- angle is -pi to +pi
-	inline double parabolicSine(double angle)
+/**
+\class SuperLFOBank
+\ingroup FX-Objects
+\brief
+The SuperLFOBank object runs N SuperLFO-style LFOs side by side and renders their mix.
+
+State is kept as structure-of-arrays (one array per variable, one element per lane) and the render
+loop has a fixed trip count with no per-lane branches: waveform, phase output, enable and solo are
+all folded into per-lane weights and gains when the controls change. That lets the compiler put
+the lanes in vector registers (2 doubles with SSE2, 4 with AVX; twice that for SuperLFOBank<N, float>)
+and keeps the cost of going to 8 or 16 LFOs a matter of a few more vector operations per sample.
+
+T is the type of the waveform math and the mix; the modulo counters and increments stay double.
+
+The random (RSH, QRSH, noise) waveforms are the exception: their lanes are serviced in a short
+scalar loop that only runs when at least one lane uses them. Lanes playing the user wavetable
+(LFOWaveform::kUser) get the same treatment: one table read each, before the main loop.
+
+The lane mode follows SuperLFO: LFOMode::kOneShot lanes stop (output 0.0) after one cycle, the other
+modes run on. retriggerLanes( ) restarts the kSync and kOneShot lanes, e.g. on a MIDI note-on;
+kFreeRun lanes ignore it.
+
+Audio I/O:
+- None; renders a modulation value.
+
+Control I/F:
+- Use SuperLFOParameters plus an LFOPhaseOutput per lane; enable/solo per lane.
+
+\author <Aaron Mutchler> <http://www.aaronmutchler.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+template <uint32_t N, typename T = double>
+class SuperLFOBank
+{
+public:
+	SuperLFOBank(void)	/* C-TOR */
+	{
+		for (uint32_t i = 0; i < N; i++)
+		{
+			laneRateScale[i] = 1.0;
+			laneDepthScale[i] = (T)1.0;
+			laneRunning[i] = (T)1.0;
+		}
+	}
+	~SuperLFOBank(void) {}	/* D-TOR */
+
+	/** reset members to initialized state; phases go back to zero */
+	bool reset(double _sampleRate)
+	{
+		sampleRate = _sampleRate;
+
+		// --- seed the random number generators, one stream per lane; an explicit seed replays the same sequences
+		uint64_t seed = useRandomSeed ? randomSeed : getLFORandomSeed();
+
+		for (uint32_t i = 0; i < N; i++)
+		{
+			// --- randomize the PN registers (an all-zero register would stick at zero)
+			random[i].seed(seed, i);
+			pnRegister[i] = random[i].nextUInt32() | 1;
+
+			modCounter[i] = 0.0;
+			randomSHCounter[i] = -1.0;
+			randomSHValue[i] = (T)0.0;
+			laneFinished[i] = false;
+			laneRunning[i] = (T)1.0;
+		}
+		cookLanes();
+
+		return true;
+	}
+
+	/** set the seed used by every following reset( ), so that the random lanes give the same sequences each time */
+	/**
+	\param seed the seed
+	*/
+	void setRandomSeed(uint64_t seed)
+	{
+		randomSeed = seed;
+		useRandomSeed = true;
+	}
+
+	/** go back to different random sequences on every reset( ) (the default) */
+	void clearRandomSeed() { useRandomSeed = false; }
+
+	/** change the rate the bank is rendered at without resetting phases, e.g. to run it at a control rate */
+	void setSampleRate(double _sampleRate)
+	{
+		sampleRate = _sampleRate;
+		cookLanes();
+	}
+
+	/** number of lanes (LFOs) in the bank */
+	uint32_t getNumLanes() { return N; }
+
+	/** get one lane's parameters */
+	SuperLFOParameters getLaneParameters(uint32_t lane) { return parameters[lane]; }
+
+	/** set one lane's parameters and which of its outputs feeds the mix */
+	/**
+	\param lane the LFO, 0 to N-1
+	\param params waveform, frequency and amplitude
+	\param phaseOutput the output used for this lane
+	*/
+	void setLaneParameters(uint32_t lane, const SuperLFOParameters& params, LFOPhaseOutput phaseOutput)
+	{
+		if (lane >= N) return;
+		parameters[lane] = params;
+		phaseOutputs[lane] = phaseOutput;
+		cookLanes();
+	}
+
+	/** set one lane's phase increment directly, e.g. from a tempo sync cache; nothing else is re-cooked */
+	/**
+	\param lane the LFO, 0 to N-1
+	\param phaseInc frequency / the rate the bank is rendered at
+	*/
+	void setLanePhaseIncrement(uint32_t lane, double phaseInc)
+	{
+		if (lane >= N) return;
+		parameters[lane].frequency_Hz = phaseInc * sampleRate;
+		laneInc[lane] = (enabled[lane] && sampleRate > 0.0) ? phaseInc : 0.0;
+		randomSHHold[lane] = phaseInc > 0.0 ? 1.0 / phaseInc : 0.0;
+	}
+
+	/** set the table played by the LFOWaveform::kUser lanes; the caller owns it and must keep it alive
+	    (and unchanged) while the bank can read it; nullptr silences those lanes */
+	/**
+	\param table the wavetable, or nullptr
+	*/
+	void setUserWavetable(const LFOWavetable* table)
+	{
+		userWavetable = (table && table->getLength() > 0) ? table : nullptr;
+	}
+
+	/** scale one lane's rate and depth on top of its parameters, e.g. from a modulation matrix; cheap
+	    enough to call every render. 1.0, 1.0 is no modulation (and gives exactly the unmodulated output).
+	    The random sample/hold clock is not rate modulated */
+	/**
+	\param lane the LFO, 0 to N-1
+	\param rateScale multiplies the phase increment
+	\param depthScale multiplies the lane's output
+	*/
+	void setLaneModulation(uint32_t lane, double rateScale, T depthScale)
+	{
+		if (lane >= N) return;
+		laneRateScale[lane] = rateScale;
+		laneDepthScale[lane] = depthScale;
+	}
+
+	/** each lane's output from the last render: waveform * amplitude * polarity (* depth modulation), not
+	    averaged; 0.0 for lanes that are disabled or muted by solo */
+	const T* getLaneOutputs() { return laneOutput; }
+
+	/** set one lane's phase directly, e.g. from the host transport position; the next render reads it */
+	/**
+	\param lane the LFO, 0 to N-1
+	\param phase the phase in cycles; only the fractional part is kept
+	*/
+	void setLanePhase(uint32_t lane, double phase)
+	{
+		if (lane >= N) return;
+		modCounter[lane] = phase - floor(phase);
+	}
+
+	/** get one lane's phase, as the next render will read it */
+	double getLanePhase(uint32_t lane) { return lane < N ? modCounter[lane] : 0.0; }
+
+	/** get one lane's phase increment per render, rate modulation included */
+	double getLanePhaseIncrement(uint32_t lane) { return lane < N ? laneInc[lane] * laneRateScale[lane] : 0.0; }
+
+	/** restart one lane: phase, random sample/hold clock and (for a one-shot) the cycle; whatever its mode */
+	/**
+	\param lane the LFO, 0 to N-1
+	\param phase the phase to restart from in cycles, e.g. to line the restart up with a later render
+	*/
+	void retriggerLane(uint32_t lane, double phase = 0.0)
+	{
+		if (lane >= N) return;
+
+		// --- a one-shot restarting part way into its cycle may already be past the end of it
+		laneFinished[lane] = oneShot[lane] && phase >= 1.0;
+		laneRunning[lane] = laneFinished[lane] ? (T)0.0 : (T)1.0;
+		modCounter[lane] = oneShot[lane] ? phase : phase - floor(phase);
+		randomSHCounter[lane] = -1.0;
+	}
+
+	/** restart every LFOMode::kSync and LFOMode::kOneShot lane, e.g. on a MIDI note-on */
+	void retriggerLanes()
+	{
+		for (uint32_t i = 0; i < N; i++)
+			if (parameters[i].mode != LFOMode::kFreeRun)
+				retriggerLane(i);
+	}
+
+	/** enable and solo one lane; a solo'd lane mutes every enabled lane that is not solo'd */
+	void setLaneEnable(uint32_t lane, bool enable, bool solo)
+	{
+		if (lane >= N) return;
+		enabled[lane] = enable;
+		soloed[lane] = solo;
+		cookLanes();
+	}
+
+	/** render one sample period and return the average of the audible lanes */
+	/**
+	\return the mix, -1.0 to +1.0 (0.0 when no lane is audible)
+	*/
+	T renderCombinedOutput()
+	{
+		// --- one-shot lanes stop at the end of their cycle
+		if (numOneShotLanes > 0)
+			updateOneShotLanes();
+
+		// --- random waveforms have state that changes on their own clock
+		if (numRandomLanes > 0)
+			updateRandomLanes();
+
+		// --- user wavetable lanes: one table read each
+		if (numUserLanes > 0)
+			readUserLanes();
+
+		// --- the branch-free part: every lane, every waveform, weighted
+		T mix = (T)0.0;
+		for (uint32_t i = 0; i < N; i++)
+		{
+			// --- wrap first, as SuperLFO::renderModulatorOutput( ) does
+			double mod = modCounter[i];
+			mod -= (mod >= 1.0) ? 1.0 : 0.0;
+
+			// --- quad phase lanes read 90 degrees ahead
+			double wrapped = mod + phaseOffset[i];
+			wrapped -= (wrapped >= 1.0) ? 1.0 : 0.0;
+
+			// --- the phase is wrapped to [0, 1) so the waveforms lose nothing in single precision
+			T phase = (T)wrapped;
+			T saw = (T)2.0*phase - (T)1.0;
+			T triangle = (T)2.0*fabs(saw) - (T)1.0;
+			T sine = parabolicSine((T)kPi - phase*(T)2.0*(T)kPi);
+
+			T output = sineWeight[i]*sine + triangleWeight[i]*triangle + sawWeight[i]*saw + randomWeight[i]*randomSHValue[i] + userWeight[i]*userValue[i];
+			output *= laneDepthScale[i]*laneRunning[i];
+			mix += output*laneGain[i];
+			laneOutput[i] = output*laneLevel[i];
+
+			modCounter[i] = mod + laneInc[i]*laneRateScale[i];
+		}
+
+		return mix;
+	}
+
+	/** advance every lane numSamples sample periods without rendering; O(1) in numSamples, used to skip silence */
+	/**
+	\param numSamples number of sample periods to skip
+	*/
+	void advance(uint64_t numSamples)
+	{
+		if (numSamples == 0)
+			return;
+
+		for (uint32_t i = 0; i < N; i++)
+		{
+			double inc = laneInc[i]*laneRateScale[i];
+			double mod = modCounter[i] + inc * (double)numSamples;
+
+			// --- a one-shot finishes if a render during the skip would have started past the end of the
+			//     cycle; otherwise it is left unwrapped so the next render finishes it if it should
+			if (oneShot[i] && enabled[i])
+			{
+				if (!laneFinished[i] && modCounter[i] + inc * (double)(numSamples - 1) >= 1.0)
+				{
+					laneFinished[i] = true;
+					laneRunning[i] = (T)0.0;
+				}
+				modCounter[i] = laneFinished[i] ? 0.0 : mod;
+				continue;
+			}
+			modCounter[i] = mod - floor(mod);
+		}
+
+		if (numRandomLanes > 0)
+			advanceRandomLanes(numSamples);
+	}
+
+protected:
+	SuperLFOParameters parameters[N];		///< per-lane parameters
+	LFOPhaseOutput phaseOutputs[N] = {};	///< per-lane output selection
+	bool enabled[N] = {};					///< per-lane enable
+	bool soloed[N] = {};					///< per-lane solo
+
+	// --- local variables used by this object
+	double sampleRate = 0.0;	///< sample rate
+	uint32_t numRandomLanes = 0;	///< lanes using RSH, QRSH or noise
+	uint32_t numUserLanes = 0;		///< lanes using the user wavetable
+	uint32_t numOneShotLanes = 0;	///< enabled lanes in LFOMode::kOneShot
+	bool oneShot[N] = {};			///< per-lane: LFOMode::kOneShot
+	bool laneFinished[N] = {};		///< per-lane: one-shot cycle done
+	const LFOWavetable* userWavetable = nullptr;	///< table for LFOWaveform::kUser lanes
+
+	// --- structure-of-arrays lane state; aligned for vector loads
+	alignas(32) double modCounter[N] = {};		///< modulo counters [0.0, +1.0]
+	alignas(32) double laneInc[N] = {};			///< phase inc = fo/fs; zero for disabled lanes (phase holds, as with a SuperLFO that is not rendered)
+	alignas(32) double phaseOffset[N] = {};		///< 0.0 or 0.25 for quad phase
+	alignas(32) T laneGain[N] = {};			///< amplitude * polarity / number of audible lanes; zero when disabled or muted by solo
+	alignas(32) T laneLevel[N] = {};		///< amplitude * polarity; zero when disabled or muted by solo
+	alignas(32) T laneOutput[N] = {};		///< last rendered output per lane, see getLaneOutputs( )
+	alignas(32) double laneRateScale[N] = {};	///< rate modulation, see setLaneModulation( ); 1.0 from the C-TOR
+	alignas(32) T laneDepthScale[N] = {};	///< depth modulation, see setLaneModulation( ); 1.0 from the C-TOR
+	alignas(32) T laneRunning[N] = {};		///< 0.0 once a one-shot lane has finished, else 1.0 (from the C-TOR)
+	alignas(32) T sineWeight[N] = {};		///< 1.0 if lane is sine, else 0.0
+	alignas(32) T triangleWeight[N] = {};	///< 1.0 if lane is triangle, else 0.0
+	alignas(32) T sawWeight[N] = {};		///< 1.0 if lane is saw, else 0.0
+	alignas(32) T randomWeight[N] = {};		///< 1.0 if lane is RSH/QRSH/noise, else 0.0
+	alignas(32) T randomSHValue[N] = {};	///< current random output per lane
+	alignas(32) T userWeight[N] = {};		///< 1.0 if lane plays the user wavetable, else 0.0
+	alignas(32) T userValue[N] = {};		///< user wavetable value at the lane's phase
+
+	double randomSHCounter[N] = {};		///< random sample/hold counter; -1 is reset condition
+	double randomSHHold[N] = {};			///< hold time in samples = sampleRate / frequency
+	uint32_t pnRegister[N] = {};			///< 32 bit registers for PN oscillators
+	LFORandom random[N];					///< per-lane white noise and random sample/hold generators
+	uint64_t randomSeed = 0;				///< explicit seed, see setRandomSeed( )
+	bool useRandomSeed = false;				///< true if reset( ) uses randomSeed
+
+	/** turn the per-lane controls into the weights and gains used by the render loop */
+	void cookLanes()
 	{
-		double y = B * angle + C * angle * fabs(angle);
-		y = P * (y * fabs(y) - y) + y;
-		return y;
+		uint32_t numAudible = 0;
+		bool anySolo = false;
+		for (uint32_t i = 0; i < N; i++)
+			anySolo |= (enabled[i] && soloed[i]);
+
+		bool audible[N];
+		for (uint32_t i = 0; i < N; i++)
+		{
+			audible[i] = enabled[i] && (!anySolo || soloed[i]);
+			if (audible[i]) numAudible++;
+		}
+
+		numRandomLanes = 0;
+		numUserLanes = 0;
+		numOneShotLanes = 0;
+		for (uint32_t i = 0; i < N; i++)
+		{
+			// --- leaving one-shot mode starts the lane running again
+			oneShot[i] = parameters[i].mode == LFOMode::kOneShot;
+			if (oneShot[i] && enabled[i]) numOneShotLanes++;
+			if (!oneShot[i])
+			{
+				laneFinished[i] = false;
+				laneRunning[i] = (T)1.0;
+			}
+
+			LFOWaveform waveform = parameters[i].waveform;
+			bool isRandom = waveform == LFOWaveform::kRSH || waveform == LFOWaveform::kQRSH ||
+							waveform == LFOWaveform::kNoise || waveform == LFOWaveform::kQRNoise;
+
+			sineWeight[i] = waveform == LFOWaveform::kSin ? (T)1.0 : (T)0.0;
+			triangleWeight[i] = waveform == LFOWaveform::kTriangle ? (T)1.0 : (T)0.0;
+			sawWeight[i] = waveform == LFOWaveform::kSaw ? (T)1.0 : (T)0.0;
+			randomWeight[i] = isRandom ? (T)1.0 : (T)0.0;
+			if (isRandom && enabled[i]) numRandomLanes++;
+
+			userWeight[i] = waveform == LFOWaveform::kUser ? (T)1.0 : (T)0.0;
+			userValue[i] = (T)0.0;
+			if (waveform == LFOWaveform::kUser && enabled[i]) numUserLanes++;
+
+			bool quad = phaseOutputs[i] == LFOPhaseOutput::kQuadPhase || phaseOutputs[i] == LFOPhaseOutput::kQuadPhaseInverted;
+			bool inverted = phaseOutputs[i] == LFOPhaseOutput::kInverted || phaseOutputs[i] == LFOPhaseOutput::kQuadPhaseInverted;
+			phaseOffset[i] = quad ? 0.25 : 0.0;
+
+			laneGain[i] = audible[i] ? (T)(parameters[i].outputAmplitude / numAudible) : (T)0.0;
+			if (inverted) laneGain[i] = -laneGain[i];
+
+			laneLevel[i] = audible[i] ? (T)parameters[i].outputAmplitude : (T)0.0;
+			if (inverted) laneLevel[i] = -laneLevel[i];
+
+			laneInc[i] = (enabled[i] && sampleRate > 0.0) ? parameters[i].frequency_Hz / sampleRate : 0.0;
+			randomSHHold[i] = (parameters[i].frequency_Hz > 0.0) ? sampleRate / parameters[i].frequency_Hz : 0.0;
+		}
 	}
 
-	#define EXTRACT_BITS(the_val, bits_start, bits_len) ((the_val >> (bits_start - 1)) & ((1 << bits_len) - 1))
+	/** skip the random lanes ahead; a lane whose hold time expired during the skip gets a new value */
+	void advanceRandomLanes(uint64_t numSamples)
+	{
+		for (uint32_t i = 0; i < N; i++)
+		{
+			if (randomWeight[i] == (T)0.0 || !enabled[i])
+				continue;
 
-	// --- quasi-random noise gnerator
-	inline double doPNSequence(uint32_t& uPNRegister)
+			// --- noise draws one value per sample
+			LFOWaveform waveform = parameters[i].waveform;
+			if (waveform == LFOWaveform::kNoise)
+			{
+				random[i].discard(numSamples - 1);
+				randomSHValue[i] = (T)random[i].nextBipolar();
+				continue;
+			}
+			if (waveform == LFOWaveform::kQRNoise)
+			{
+				randomSHValue[i] = (T)doPNSequence(pnRegister[i], numSamples);
+				continue;
+			}
+
+			// --- lanes that have not started will start on the next render
+			if (randomSHCounter[i] < 0.0 || randomSHHold[i] < 1.0)
+				continue;
+
+			uint64_t holds = getRandomSHHolds(randomSHCounter[i], randomSHHold[i], numSamples);
+			if (holds == 0)
+				continue;
+
+			if (waveform == LFOWaveform::kRSH)
+			{
+				random[i].discard(holds - 1);
+				randomSHValue[i] = (T)random[i].nextBipolar();
+			}
+			else
+				randomSHValue[i] = (T)doPNSequence(pnRegister[i], holds);
+		}
+	}
+
+	/** finish the one-shot lanes whose phase has reached the end of the cycle, as SuperLFO does when its
+	    counter wraps; a finished lane holds phase 0.0 until it is retriggered */
+	void updateOneShotLanes()
 	{
-		// --- get the bits
-		uint32_t b0 = EXTRACT_BITS(uPNRegister, 1, 1); // 1 = b0 is FIRST bit from right
-		uint32_t b1 = EXTRACT_BITS(uPNRegister, 2, 1); // 1 = b1 is SECOND bit from right
-		uint32_t b27 = EXTRACT_BITS(uPNRegister, 28, 1); // 28 = b27 is 28th bit from right
-		uint32_t b28 = EXTRACT_BITS(uPNRegister, 29, 1); // 29 = b28 is 29th bit from right
+		for (uint32_t i = 0; i < N; i++)
+		{
+			if (!oneShot[i] || !enabled[i])
+				continue;
 
-		// --- form the XOR
-		uint32_t b31 = b0^b1^b27^b28;
+			if (!laneFinished[i] && modCounter[i] >= 1.0)
+			{
+				laneFinished[i] = true;
+				laneRunning[i] = (T)0.0;
+			}
+			if (laneFinished[i])
+				modCounter[i] = 0.0;
+		}
+	}
 
-		// --- form the mask to OR with the register to load b31
-		if (b31 == 1)
-			b31 = 0x10000000;
+	/** read the user wavetable at each user lane's phase, wrapped as in renderCombinedOutput( ) */
+	void readUserLanes()
+	{
+		for (uint32_t i = 0; i < N; i++)
+		{
+			if (userWeight[i] == (T)0.0 || !enabled[i])
+				continue;
 
-		// --- shift one bit to right
-		uPNRegister >>= 1;
+			if (!userWavetable)
+			{
+				userValue[i] = (T)0.0;
+				continue;
+			}
+
+			double mod = modCounter[i];
+			mod -= (mod >= 1.0) ? 1.0 : 0.0;
+			double wrapped = mod + phaseOffset[i];
+			wrapped -= (wrapped >= 1.0) ? 1.0 : 0.0;
+
+			userValue[i] = (T)userWavetable->readTable(wrapped);
+		}
+	}
 
-		// --- set the b31 bit
-		uPNRegister |= b31;
+	/** advance the random lanes one sample; same hold logic as SuperLFO */
+	void updateRandomLanes()
+	{
+		for (uint32_t i = 0; i < N; i++)
+		{
+			if (randomWeight[i] == (T)0.0 || !enabled[i])
+				continue;
 
-		// --- convert the output into a floating point number, scaled by experimentation
-		// --- to a range of o to +2.0
-		float fOut = (float)(uPNRegister) / ((pow((float)2.0, (float)32.0)) / 16.0);
+			LFOWaveform waveform = parameters[i].waveform;
+			if (waveform == LFOWaveform::kNoise)
+			{
+				randomSHValue[i] = (T)random[i].nextBipolar();
+				continue;
+			}
+			if (waveform == LFOWaveform::kQRNoise)
+			{
+				randomSHValue[i] = (T)doPNSequence(pnRegister[i]);
+				continue;
+			}
 
-		// --- shift down to form a result from -1.0 to +1.0
-		fOut -= 1.0;
+			// --- is this is the very first run? if so, form first output sample
+			if (randomSHCounter[i] < 0.0)
+			{
+				randomSHValue[i] = (T)(waveform == LFOWaveform::kRSH ? random[i].nextBipolar() : doPNSequence(pnRegister[i]));
+				randomSHCounter[i] = 1.0;
+			}
+			// --- has hold time been exceeded? if so, generate next output sample
+			else if (randomSHCounter[i] > randomSHHold[i])
+			{
+				randomSHCounter[i] -= randomSHHold[i];
+				randomSHValue[i] = (T)(waveform == LFOWaveform::kRSH ? random[i].nextBipolar() : doPNSequence(pnRegister[i]));
+			}
 
-		return fOut;
+			// --- advance the sample counter
+			randomSHCounter[i] += 1.0;
+		}
 	}
 };
 
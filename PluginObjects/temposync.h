@@ -0,0 +1,171 @@
+#pragma once
+
+#ifndef __TempoSync__
+#define __TempoSync__
+
+#include "fxobjects.h"
+
+// --- number of tempo sync divisions; a division of 0 means "not synced"
+const uint32_t TEMPOSYNC_NUM_DIVISIONS = 6;
+
+// --- the divisions: eighth note triplets, eighth note, quarter note triplet, quarter note, half note, whole note
+const double kTempoSyncNoteValues[TEMPOSYNC_NUM_DIVISIONS] = { 0.125, 0.334, 0.5, 1.0, 2.0, 4.0 };
+
+// --- synced LFO rates are held to the same range as the free running rate control
+const double kTempoSyncMinFrequency = 0.02;
+const double kTempoSyncMaxFrequency = 20.0;
+
+/**
+\class TempoSync
+\ingroup FX-Objects
+\brief
+The TempoSync object caches the phase increments of N tempo synced LFOs.
+
+The increments are only recomputed when the tempo or a lane's division changes (at most once per
+buffer), so nothing is divided per sample and the results can be written straight into the LFO
+phase incrementers. A linear tempo ramp may be started for hosts that report one; it is stepped
+once per LFO render so the synced rates follow the tempo from render to render.
+
+Audio I/O:
+- None.
+
+Control I/F:
+- setTempo( ) or rampToTempo( ), setDivision( ) per lane, setSampleRate( ) for the LFO render rate.
+
+\author <Aaron Mutchler> <http://www.aaronmutchler.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+template <uint32_t N>
+class TempoSync
+{
+public:
+	TempoSync(void) {}	/* C-TOR */
+	~TempoSync(void) {}	/* D-TOR */
+
+	/** set the rate the LFOs are rendered at; every cached increment is recomputed */
+	/**
+	\param _sampleRate LFO render rate (the control rate if the LFOs are not run every sample)
+	*/
+	void setSampleRate(double _sampleRate)
+	{
+		sampleRate = _sampleRate;
+		for (uint32_t i = 0; i < N; i++)
+			cookLane(i);
+	}
+
+	/** jump to a new tempo, cancelling any ramp */
+	/**
+	\param _bpm tempo in beats per minute
+	\return true if the tempo changed, i.e. the synced increments are new
+	*/
+	bool setTempo(double _bpm)
+	{
+		rampTicks = 0;
+		if (_bpm == bpm)
+			return false;
+
+		bpm = _bpm;
+		for (uint32_t i = 0; i < N; i++)
+			cookLane(i);
+		return true;
+	}
+
+	/** start a linear ramp from the current tempo to a new one */
+	/**
+	\param _bpm tempo at the end of the ramp
+	\param numTicks length of the ramp in LFO renders; 0 jumps straight there
+	\return true if the tempo changed
+	*/
+	bool rampToTempo(double _bpm, uint32_t numTicks)
+	{
+		if (numTicks == 0 || _bpm == bpm)
+			return setTempo(_bpm);
+
+		targetBPM = _bpm;
+		bpmStep = (targetBPM - bpm) / numTicks;
+		rampTicks = numTicks;
+		return true;
+	}
+
+	/** true while a tempo ramp is running */
+	bool isRamping() { return rampTicks > 0; }
+
+	/** move the ramp on by numTicks LFO renders; the synced increments follow */
+	void advanceRamp(uint32_t numTicks)
+	{
+		if (rampTicks == 0 || numTicks == 0)
+			return;
+
+		if (numTicks >= rampTicks)
+		{
+			rampTicks = 0;
+			bpm = targetBPM;
+		}
+		else
+		{
+			rampTicks -= numTicks;
+			bpm += bpmStep*numTicks;
+		}
+
+		for (uint32_t i = 0; i < N; i++)
+			if (isSynced(i)) cookLane(i);
+	}
+
+	/** set a lane's sync division */
+	/**
+	\param lane the LFO, 0 to N-1
+	\param _division 1 to TEMPOSYNC_NUM_DIVISIONS, anything else turns sync off for the lane
+	*/
+	void setDivision(uint32_t lane, int _division)
+	{
+		if (lane >= N) return;
+		division[lane] = (_division > 0 && _division <= (int)TEMPOSYNC_NUM_DIVISIONS) ? _division : 0;
+		cookLane(lane);
+	}
+
+	/** true if the lane follows the tempo */
+	bool isSynced(uint32_t lane) { return lane < N && division[lane] > 0; }
+
+	/** the current tempo, part way through a ramp if one is running */
+	double getTempo() { return bpm; }
+
+	/** the lane's synced rate in Hz; 0.0 if the lane is not synced */
+	double getFrequency(uint32_t lane) { return lane < N ? frequency_Hz[lane] : 0.0; }
+
+	/** the lane's synced phase increment (frequency / LFO render rate); 0.0 if the lane is not synced */
+	double getPhaseIncrement(uint32_t lane) { return lane < N ? phaseInc[lane] : 0.0; }
+
+	/** the lane's synced rate in cycles per quarter note, for placing its phase from a musical position; 0.0 if the lane is not synced */
+	double getCyclesPerQuarterNote(uint32_t lane) { return (lane < N && bpm > 0.0) ? frequency_Hz[lane] * 60.0 / bpm : 0.0; }
+
+protected:
+	double sampleRate = 0.0;	///< LFO render rate
+	double bpm = 0.0;			///< current tempo
+	double targetBPM = 0.0;		///< tempo at the end of the ramp
+	double bpmStep = 0.0;		///< tempo change per LFO render while ramping
+	uint32_t rampTicks = 0;		///< LFO renders left in the ramp
+
+	int division[N] = {};				///< per-lane division, 0 = not synced
+	double frequency_Hz[N] = {};		///< per-lane synced rate
+	double phaseInc[N] = {};			///< per-lane synced phase increment
+
+	/** recompute one lane's cached rate and increment */
+	void cookLane(uint32_t lane)
+	{
+		if (division[lane] == 0)
+		{
+			frequency_Hz[lane] = 0.0;
+			phaseInc[lane] = 0.0;
+			return;
+		}
+
+		double bps = bpm / 60.0;
+		frequency_Hz[lane] = 1.0 / (bps * kTempoSyncNoteValues[division[lane] - 1]);
+		boundValue(frequency_Hz[lane], kTempoSyncMinFrequency, kTempoSyncMaxFrequency);
+		phaseInc[lane] = sampleRate > 0.0 ? frequency_Hz[lane] / sampleRate : 0.0;
+	}
+};
+
+#endif
@@ -0,0 +1,243 @@
+#pragma once
+
+#ifndef __VBAP__
+#define __VBAP__
+
+#include <math.h>
+#include <stdint.h>
+#include "guiconstants.h"
+#include "pluginstructures.h"
+
+// --- most channels a speaker layout can have (7.1)
+const uint32_t VBAP_MAX_SPEAKERS = 8;
+
+const double kVBAPDegreesToRadians = kPi / 180.0;
+
+/**
+\struct SpeakerLayout
+\ingroup FX-Objects
+\brief
+Where the channels of a channel format sit on the horizontal speaker ring. Azimuths are in degrees,
+0 = front, counter-clockwise (positive = left), as in the VBAP literature.
+*/
+struct SpeakerLayout
+{
+	uint32_t numChannels = 0;						///< channels in the format
+	double azimuth[VBAP_MAX_SPEAKERS] = {};			///< per-channel azimuth, degrees
+	bool onRing[VBAP_MAX_SPEAKERS] = {};			///< false for the LFE and speakers that are not on the ring (proximity)
+	int32_t lfeChannel = -1;						///< index of the LFE channel, -1 for none
+};
+
+/** look up the speaker layout of a channel format; channels are in the VST3 speaker arrangement order */
+/**
+\param format a channelFormat value
+\param layout returned layout
+\return true if the format is known; the height formats (8.1 and up) are not
+*/
+inline bool getSpeakerLayout(uint32_t format, SpeakerLayout& layout)
+{
+	// --- front, centre, 5.x surrounds, centre surround, SDDS left/right centre, 7.x sides and rears, quad
+	const double L = 30.0, R = -30.0, C = 0.0, Ls = 110.0, Rs = -110.0, Cs = 180.0;
+	const double Lc = 15.0, Rc = -15.0, Sl = 90.0, Sr = -90.0, Lsr = 150.0, Rsr = -150.0;
+	const double Lq = 45.0, Rq = -45.0, Lsq = 135.0, Rsq = -135.0;
+	const double LFE = 0.0;
+
+	const double* azimuths = nullptr;
+	uint32_t numChannels = 0;
+	int32_t lfeChannel = -1;
+	uint32_t numOffRing = 0;	// --- trailing channels that are not on the ring
+
+	static const double mono[] = { C };
+	static const double stereo[] = { L, R };
+	static const double lcr[] = { L, R, C };
+	static const double lcrs[] = { L, R, C, Cs };
+	static const double quad[] = { Lq, Rq, Lsq, Rsq };
+	static const double s5p0[] = { L, R, C, Ls, Rs };
+	static const double s5p1[] = { L, R, C, LFE, Ls, Rs };
+	static const double s6p0[] = { L, R, C, Ls, Rs, Cs };
+	static const double s6p1[] = { L, R, C, LFE, Ls, Rs, Cs };
+	static const double s7p0Sony[] = { L, R, C, Ls, Rs, Lc, Rc };
+	static const double s7p0DTS[] = { L, R, C, Lsr, Rsr, Sl, Sr };
+	static const double s7p1Sony[] = { L, R, C, LFE, Ls, Rs, Lc, Rc };
+	static const double s7p1DTS[] = { L, R, C, LFE, Lsr, Rsr, Sl, Sr };
+	static const double s7p1Proximity[] = { L, R, C, LFE, Ls, Rs, L, R };
+
+	switch (format)
+	{
+		case kCFMono: azimuths = mono; numChannels = 1; break;
+		case kCFStereo: azimuths = stereo; numChannels = 2; break;
+		case kCFLCR: azimuths = lcr; numChannels = 3; break;
+		case kCFLCRS: azimuths = lcrs; numChannels = 4; break;
+		case kCFQuad: azimuths = quad; numChannels = 4; break;
+		case kCF5p0: azimuths = s5p0; numChannels = 5; break;
+		case kCF5p1: azimuths = s5p1; numChannels = 6; lfeChannel = 3; break;
+		case kCF6p0: azimuths = s6p0; numChannels = 6; break;
+		case kCF6p1: azimuths = s6p1; numChannels = 7; lfeChannel = 3; break;
+		case kCF7p0Sony: azimuths = s7p0Sony; numChannels = 7; break;
+		case kCF7p0DTS: azimuths = s7p0DTS; numChannels = 7; break;
+		case kCF7p1Sony: azimuths = s7p1Sony; numChannels = 8; lfeChannel = 3; break;
+		case kCF7p1DTS: azimuths = s7p1DTS; numChannels = 8; lfeChannel = 3; break;
+		case kCF7p1Proximity: azimuths = s7p1Proximity; numChannels = 8; lfeChannel = 3; numOffRing = 2; break;
+		default: return false;
+	}
+
+	layout.numChannels = numChannels;
+	layout.lfeChannel = lfeChannel;
+	for (uint32_t ch = 0; ch < VBAP_MAX_SPEAKERS; ch++)
+	{
+		layout.azimuth[ch] = ch < numChannels ? azimuths[ch] : 0.0;
+		layout.onRing[ch] = ch < numChannels - numOffRing && (int32_t)ch != lfeChannel;
+	}
+	return true;
+}
+
+/**
+\class VBAPPanner
+\ingroup FX-Objects
+\brief
+The VBAPPanner object implements 2-D vector base amplitude panning (Pulkki) over a horizontal ring
+of speakers: a source at any azimuth is placed between the two ring speakers either side of it,
+with gains from the inverse of the pair's speaker-vector matrix, normalized to constant power.
+
+setLayout( ) sorts the ring and inverts every pair's 2x2 matrix once, so calculateGains( ) is a
+short search and two dot products. Pairs 180 degrees or more apart (the back of an LCR layout)
+have no valid VBAP solution; those use a constant power crossfade over the angle instead.
+
+Control I/F:
+- setLayout( ) off the hot path; calculateGains( ) at control rate.
+
+\author <Aaron Mutchler> <http://www.aaronmutchler.com>
+\remark <Put any remarks or notes here>
+\version Revision : 1.0
+\date Date : 2019 / 01 / 31
+*/
+class VBAPPanner
+{
+public:
+	VBAPPanner(void) {}	/* C-TOR */
+	~VBAPPanner(void) {}	/* D-TOR */
+
+	/** take the ring speakers of a layout and prepare their pairs */
+	/**
+	\param layout the output speaker layout
+	\return true if the ring has at least two speakers
+	*/
+	bool setLayout(const SpeakerLayout& layout)
+	{
+		numRingSpeakers = 0;
+		for (uint32_t ch = 0; ch < layout.numChannels && ch < VBAP_MAX_SPEAKERS; ch++)
+		{
+			if (!layout.onRing[ch])
+				continue;
+
+			// --- insertion sort by azimuth, 0 .. 360
+			double azimuth = wrapDegrees(layout.azimuth[ch]);
+			uint32_t j = numRingSpeakers;
+			for (; j > 0 && ringAzimuth[j - 1] > azimuth; j--)
+			{
+				ringAzimuth[j] = ringAzimuth[j - 1];
+				ringChannel[j] = ringChannel[j - 1];
+			}
+			ringAzimuth[j] = azimuth;
+			ringChannel[j] = ch;
+			numRingSpeakers++;
+		}
+
+		if (numRingSpeakers < 2)
+			return false;
+
+		// --- pair i runs from ring speaker i to ring speaker i + 1, the last one round the back to the first
+		for (uint32_t i = 0; i < numRingSpeakers; i++)
+		{
+			double a1 = ringAzimuth[i];
+			double a2 = i + 1 < numRingSpeakers ? ringAzimuth[i + 1] : ringAzimuth[0] + 360.0;
+			pairAperture[i] = a2 - a1;
+
+			// --- [g1 g2] = p * inverse([l1; l2]) with l = (cos a, sin a); det = sin(a2 - a1)
+			double r1 = a1 * kVBAPDegreesToRadians;
+			double r2 = a2 * kVBAPDegreesToRadians;
+			double det = sin(r2 - r1);
+			pairValid[i] = pairAperture[i] < 180.0 && fabs(det) > 1.0e-9;
+			if (!pairValid[i])
+				continue;
+
+			pairInverse[i][0] = sin(r2) / det;
+			pairInverse[i][1] = -cos(r2) / det;
+			pairInverse[i][2] = -sin(r1) / det;
+			pairInverse[i][3] = cos(r1) / det;
+		}
+		return true;
+	}
+
+	/** constant power gains for a source direction */
+	/**
+	\param azimuth source direction, degrees, any range
+	\param channelA returned channel of the first speaker
+	\param channelB returned channel of the second speaker
+	\param gainA returned gain of the first speaker
+	\param gainB returned gain of the second speaker; gainA^2 + gainB^2 = 1
+	*/
+	void calculateGains(double azimuth, uint32_t& channelA, uint32_t& channelB, double& gainA, double& gainB) const
+	{
+		azimuth = wrapDegrees(azimuth);
+
+		// --- the pair that starts at the last ring speaker at or before the source; below the first
+		//     speaker we are in the pair that wraps round the back
+		uint32_t pair = numRingSpeakers - 1;
+		for (uint32_t i = 0; i + 1 < numRingSpeakers; i++)
+		{
+			if (azimuth >= ringAzimuth[i] && azimuth < ringAzimuth[i + 1])
+			{
+				pair = i;
+				break;
+			}
+		}
+		if (azimuth < ringAzimuth[pair])
+			azimuth += 360.0;
+
+		channelA = ringChannel[pair];
+		channelB = ringChannel[pair + 1 < numRingSpeakers ? pair + 1 : 0];
+
+		if (pairValid[pair])
+		{
+			double r = azimuth * kVBAPDegreesToRadians;
+			double px = cos(r);
+			double py = sin(r);
+			gainA = px*pairInverse[pair][0] + py*pairInverse[pair][1];
+			gainB = px*pairInverse[pair][2] + py*pairInverse[pair][3];
+
+			// --- rounding can leave a hair below zero at a speaker
+			if (gainA < 0.0) gainA = 0.0;
+			if (gainB < 0.0) gainB = 0.0;
+			double norm = sqrt(gainA*gainA + gainB*gainB);
+			if (norm > 0.0)
+			{
+				gainA /= norm;
+				gainB /= norm;
+			}
+			return;
+		}
+
+		// --- too wide for VBAP: constant power crossfade over the angle
+		double fraction = (azimuth - ringAzimuth[pair]) / pairAperture[pair];
+		gainA = cos(fraction * kPi * 0.5);
+		gainB = sin(fraction * kPi * 0.5);
+	}
+
+protected:
+	/** fold an angle into 0 .. 360 degrees */
+	static double wrapDegrees(double degrees)
+	{
+		degrees = fmod(degrees, 360.0);
+		return degrees < 0.0 ? degrees + 360.0 : degrees;
+	}
+
+	uint32_t numRingSpeakers = 0;						///< speakers on the ring
+	double ringAzimuth[VBAP_MAX_SPEAKERS] = {};			///< ring speaker azimuths, ascending, 0 .. 360
+	uint32_t ringChannel[VBAP_MAX_SPEAKERS] = {};		///< ring speaker channel indexes
+	double pairAperture[VBAP_MAX_SPEAKERS] = {};		///< angle from each ring speaker to the next, degrees
+	double pairInverse[VBAP_MAX_SPEAKERS][4] = {};		///< inverted speaker-vector matrix of each pair
+	bool pairValid[VBAP_MAX_SPEAKERS] = {};				///< false = pair too wide for VBAP
+};
+
+#endif
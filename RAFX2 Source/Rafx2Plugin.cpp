@@ -45,7 +45,29 @@ bool Rafx2Plugin::prepareForPlay(ResetInfo& info)
 bool Rafx2Plugin::processAudioBuffers(ProcessBufferInfo& processInfo)
 {
 	if (!pluginCore) return false;
-	return pluginCore->processAudioBuffers(processInfo);
+
+	// --- RackAFX fills in its own ProcessBufferInfo, which predates the silence flags; copy the
+	//     fields it knows about into ours so nothing past them is read from or written to host memory
+	ProcessBufferInfo info;
+	info.inputs = processInfo.inputs;
+	info.outputs = processInfo.outputs;
+	info.auxInputs = processInfo.auxInputs;
+	info.auxOutputs = processInfo.auxOutputs;
+	info.numAudioInChannels = processInfo.numAudioInChannels;
+	info.numAudioOutChannels = processInfo.numAudioOutChannels;
+	info.numAuxAudioInChannels = processInfo.numAuxAudioInChannels;
+	info.numAuxAudioOutChannels = processInfo.numAuxAudioOutChannels;
+	info.numFramesToProcess = processInfo.numFramesToProcess;
+	info.channelIOConfig = processInfo.channelIOConfig;
+	info.auxChannelIOConfig = processInfo.auxChannelIOConfig;
+	info.controlSignalInputs = processInfo.controlSignalInputs;
+	info.controlSignalOutputs = processInfo.controlSignalOutputs;
+	info.numControlSignalInputs = processInfo.numControlSignalInputs;
+	info.numControlSignalOutputs = processInfo.numControlSignalOutputs;
+	info.hostInfo = processInfo.hostInfo;
+	info.midiEventQueue = processInfo.midiEventQueue;
+
+	return pluginCore->processAudioBuffers(info);
 }
 
 bool Rafx2Plugin::processMIDIEvent(midiEvent& event)